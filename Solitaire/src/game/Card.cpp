@@ -30,6 +30,20 @@ bool Card::isValid() const {
     return valid;
 }
 
+unsigned char Card::pack() const {
+    if (!valid) return 0xFF;
+    unsigned char index = static_cast<unsigned char>(static_cast<int>(suit) * 13 + static_cast<int>(rank) - 1);
+    return facingUp ? (index | 0x40) : index;
+}
+
+Card Card::unpack(unsigned char packed) {
+    if (packed == 0xFF) return Card();
+    int index = packed & 0x3F;
+    Card card(static_cast<Suit>(index / 13), static_cast<Rank>(index % 13 + 1));
+    card.facingUp = (packed & 0x40) != 0;
+    return card;
+}
+
 void Card::writeCard(BufferedIO::BufferedFileWriter& writer) {
     writer.writeInt(static_cast<int>(suit));
     writer.writeInt(static_cast<int>(rank));
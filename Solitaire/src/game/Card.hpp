@@ -92,6 +92,19 @@ public:
      */
     bool isValid() const;
 
+    /**
+     * @brief Packs the card into a single byte: suit and rank index in the low 6 bits, facing state in bit 6.
+     * @return Packed card, 0xFF for an invalid card.
+     */
+    unsigned char pack() const;
+
+    /**
+     * @brief Creates a card from a byte created by pack.
+     * @param packed Packed card.
+     * @return The unpacked card.
+     */
+    static Card unpack(unsigned char packed);
+
     /**
     * @brief Writes card into buffered writer
     * @param writer Reference to writer 
@@ -5,6 +5,10 @@ Deck::Deck() {
     reset();  
 }
 
+Deck::Deck(unsigned int seed) : seeded(true), seed(seed) {
+    reset();
+}
+
 
 void Deck::reset() {
 	cards.clear();
@@ -17,9 +21,17 @@ void Deck::reset() {
 }
 
 void Deck::shuffle() {
-    std::random_device rd;
-    std::mt19937 g(rd());
+    std::mt19937 g;
+    if (seeded) {
+        std::seed_seq sequence{ seed, shuffleCount };
+        g.seed(sequence);
+    }
+    else {
+        std::random_device rd;
+        g.seed(rd());
+    }
     std::shuffle(cards.begin(), cards.end(), g);
+    shuffleCount++;
 }
 
 Card Deck::drawCard() {
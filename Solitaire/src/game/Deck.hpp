@@ -16,6 +16,12 @@ public:
      */
     Deck();
 
+    /**
+     * @brief Constructs a new Deck whose shuffles are driven by the given seed, so deals can be reproduced.
+     * @param seed Seed for the deck's random generator.
+     */
+    explicit Deck(unsigned int seed);
+
     /**
      * @brief Shuffles the deck randomly.
      */
@@ -49,6 +55,34 @@ public:
         return cards;
     }
 
+    inline const std::vector<Card>& getCards() const {
+        return cards;
+    }
+
+    /**
+     * @brief Gets the number of shuffles done by this deck, including the initial one.
+     * @return Shuffle count.
+     */
+    inline unsigned int getShuffleCount() const {
+        return shuffleCount;
+    }
+
+    /**
+     * @brief Checks if shuffles are derived from a seed.
+     * @return true for decks created with a seed.
+     */
+    inline bool isSeeded() const {
+        return seeded;
+    }
+
+    /**
+     * @brief Gets the seed shuffles are derived from, together with the shuffle count.
+     * @return Seed of the deal, meaningful only for seeded decks.
+     */
+    inline unsigned int getSeed() const {
+        return seed;
+    }
+
     inline void setCards(std::vector<Card> cards) {
         this->cards = cards;
     }
@@ -56,4 +90,10 @@ public:
 private:
     /// Container holding the cards in the deck.
     std::vector<Card> cards;
+    /// Whether shuffles are derived from seed instead of std::random_device.
+    bool seeded = false;
+    /// Seed of the deal, used only when seeded is set.
+    unsigned int seed = 0;
+    /// Number of shuffles done so far, mixed into the seed so every reshuffle differs.
+    unsigned int shuffleCount = 0;
 };
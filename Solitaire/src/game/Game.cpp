@@ -1,10 +1,34 @@
 #include "Game.hpp"
+#include "Tableau.hpp"
 #include "util/fs.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
 
 Game::Game() : deck(), currentCard()  {}
 
+/// @brief Builds an event for cards going from one place to another.
+static GameEvent cardMoved(CardPlace from, int fromIndex, CardPlace to, int toIndex, int count, const Card& first) {
+    return { GameEventType::CardMoved, from, static_cast<unsigned char>(fromIndex), to,
+        static_cast<unsigned char>(toIndex), static_cast<unsigned char>(count), first.pack() };
+}
+
+/// @brief Builds an event for a change of a single place.
+static GameEvent placeChanged(GameEventType type, CardPlace place, int index, const Card& card) {
+    return { type, place, static_cast<unsigned char>(index), place, static_cast<unsigned char>(index), 0, card.pack() };
+}
+
 void Game::reset() {
     deck = Deck();
+    dealNewGame();
+}
+
+void Game::reset(unsigned int seed) {
+    deck = Deck(seed);
+    dealNewGame();
+}
+
+void Game::dealNewGame() {
     currentCard = Card();
     for (int i = 0; i < columnsSize;i++) {
         columns[i].clear();
@@ -14,6 +38,7 @@ void Game::reset() {
     }
     pile.clear();
     start();
+    events.publish(placeChanged(GameEventType::GameReset, CardPlace::Deck, 0, Card()));
 }
 
 void Game::start() {
@@ -33,6 +58,7 @@ bool Game::drawCard() {
     currentCard = deck.drawCard();
     currentCard.flip();
     pile.push_back(currentCard);
+    events.publish(cardMoved(CardPlace::Deck, 0, CardPlace::Pile, 0, 1, currentCard));
     return true;
 }
 
@@ -43,6 +69,13 @@ std::vector<Card>& Game::getColumn(int index)
     return columns[index];
 }
 
+const std::vector<Card>& Game::getColumn(int index) const
+{
+    ASSERT(index < columnsSize && index >= 0);
+
+    return columns[index];
+}
+
 
 Card& Game::getCurrentCard() {
     return currentCard;
@@ -58,6 +91,7 @@ void Game::setReserveSlot(int index, Card& card)
 {
     ASSERT(index < 4 && index >= 0);
     reserveSlots[index] = card;
+    events.publish(placeChanged(GameEventType::FoundationChanged, CardPlace::Reserve, index, card));
 }
 
 std::vector<Card>& Game::getPile()
@@ -65,6 +99,17 @@ std::vector<Card>& Game::getPile()
     return pile;
 }
 
+const std::vector<Card>& Game::getPile() const
+{
+    return pile;
+}
+
+const Card& Game::getReserveSlot(int index) const
+{
+    ASSERT(index < 4 && index >= 0);
+    return reserveSlots[index];
+}
+
 
 bool Game::isDeckEmpty() const {
     return deck.isEmpty();
@@ -84,22 +129,18 @@ bool Game::moveCard(int fromCol, int toCol, int count) {
     if (!startCard.isFacingUp())
         return false;
 
-    if (to.empty()) {
-        if (startCard.getRank() != Rank::King)
-            return false;
-    }
-    else {
-        Card& top = to.back();
-        if (top.isRed() == startCard.isRed() || static_cast<int>(top.getRank()) != static_cast<int>(startCard.getRank()) + 1)
-            return false;
-    }
+    if (!canPlaceOnColumn(startCard, toCol))
+        return false;
 
     std::vector<Card> movingCards(from.end() - count, from.end());
     to.insert(to.end(), movingCards.begin(), movingCards.end());
     from.erase(from.end() - count, from.end());
+    events.publish(cardMoved(CardPlace::Column, fromCol, CardPlace::Column, toCol, count, movingCards.front()));
 
-    if (!from.empty() && !from.back().isFacingUp())
+    if (!from.empty() && !from.back().isFacingUp()) {
         from.back().flip();
+        events.publish(placeChanged(GameEventType::CardFlipped, CardPlace::Column, fromCol, from.back()));
+    }
 
     return true;
 }
@@ -111,20 +152,12 @@ bool Game::moveFromPileToColumn(int toCol) {
         return false;
 
     Card card = pile.back();
-    auto& to = columns[toCol];
-
-    if (to.empty()) {
-        if (card.getRank() != Rank::King)
-            return false;
-    }
-    else {
-        Card& top = to.back();
-        if (top.isRed() == card.isRed() || static_cast<int>(top.getRank()) != static_cast<int>(card.getRank()) + 1)
-            return false;
-    }
+    if (!canPlaceOnColumn(card, toCol))
+        return false;
 
-    to.push_back(card);
+    columns[toCol].push_back(card);
     pile.pop_back();
+    events.publish(cardMoved(CardPlace::Pile, 0, CardPlace::Column, toCol, 1, card));
     return true;
 }
 
@@ -136,10 +169,11 @@ bool Game::moveFromPileToReserve(int slot) {
 
     Card card = pile.back();
 
-    bool cardValid = reserveSlots[slot].isValid();
-    if ((!cardValid && card.getRank() == Rank::Ace && static_cast<int>(card.getSuit()) == slot) || (cardValid && card.getRank() > reserveSlots[slot].getRank()) && static_cast<int>(card.getSuit()) == slot) {
+    if (canPlaceOnReserve(card, slot)) {
         reserveSlots[slot] = card;
         pile.pop_back();
+        events.publish(cardMoved(CardPlace::Pile, 0, CardPlace::Reserve, slot, 1, card));
+        events.publish(placeChanged(GameEventType::FoundationChanged, CardPlace::Reserve, slot, card));
         return true;
     }
 
@@ -158,13 +192,16 @@ bool Game::moveFromColumnToReserve(int fromCol, int slot) {
     if (!card.isFacingUp())
         return false;
 
-    bool cardValid = reserveSlots[slot].isValid();
-    if ((!cardValid && card.getRank() == Rank::Ace && static_cast<int>(card.getSuit()) == slot) || (cardValid && card.getRank() > reserveSlots[slot].getRank()) && static_cast<int>(card.getSuit()) == slot) {
+    if (canPlaceOnReserve(card, slot)) {
         reserveSlots[slot] = card;
         column.pop_back();
+        events.publish(cardMoved(CardPlace::Column, fromCol, CardPlace::Reserve, slot, 1, reserveSlots[slot]));
+        events.publish(placeChanged(GameEventType::FoundationChanged, CardPlace::Reserve, slot, reserveSlots[slot]));
 
-        if (!column.empty() && !column.back().isFacingUp())
+        if (!column.empty() && !column.back().isFacingUp()) {
             column.back().flip();
+            events.publish(placeChanged(GameEventType::CardFlipped, CardPlace::Column, fromCol, column.back()));
+        }
 
         return true;
     }
@@ -179,15 +216,8 @@ bool Game::moveFromReserveToColumn(int slot, int toCol) {
     auto& column = columns[toCol];
     Card card = reserveSlots[slot];
 
-    if (column.empty()) {
-        if (card.getRank() != Rank::King)
-            return false;
-    }
-    else {
-        Card& top = column.back();
-        if (top.isRed() == card.isRed() || static_cast<int>(top.getRank()) != static_cast<int>(card.getRank()) + 1)
-            return false;
-    }
+    if (!card.isValid() || !canPlaceOnColumn(card, toCol))
+        return false;
 
     column.push_back(card);
     if (card.getRank() != Rank::Ace) {
@@ -197,14 +227,188 @@ bool Game::moveFromReserveToColumn(int slot, int toCol) {
     else {
         reserveSlots[slot] = Card();
     }
+    events.publish(cardMoved(CardPlace::Reserve, slot, CardPlace::Column, toCol, 1, card));
+    events.publish(placeChanged(GameEventType::FoundationChanged, CardPlace::Reserve, slot, reserveSlots[slot]));
+    return true;
+}
+
+bool Game::recycleStock() {
+    if (!deck.isEmpty() || pile.empty())
+        return false;
+
+    GameEvent recycled{ GameEventType::StockRecycled, CardPlace::Pile, 0, CardPlace::Deck, 0, static_cast<unsigned char>(pile.size()), 0 };
+    deck.reShuffle(pile);
+    events.publish(recycled);
+    return true;
+}
+
+bool Game::applyMove(const Move& move) {
+    switch (move.type) {
+    case MoveType::Draw:            return drawCard();
+    case MoveType::ColumnToColumn:  return moveCard(move.from, move.to, move.count);
+    case MoveType::PileToColumn:    return moveFromPileToColumn(move.to);
+    case MoveType::PileToReserve:   return moveFromPileToReserve(move.to);
+    case MoveType::ColumnToReserve: return moveFromColumnToReserve(move.from, move.to);
+    case MoveType::ReserveToColumn: return moveFromReserveToColumn(move.from, move.to);
+    case MoveType::Recycle:         return recycleStock();
+    }
+    return false;
+}
+
+bool Game::canPlaceOnColumn(const Card& card, int toCol) const {
+    const auto& to = columns[toCol];
+    if (to.empty())
+        return card.getRank() == Rank::King;
+
+    const Card& top = to.back();
+    return top.isRed() != card.isRed() && static_cast<int>(top.getRank()) == static_cast<int>(card.getRank()) + 1;
+}
+
+bool Game::canPlaceOnReserve(const Card& card, int slot) const {
+    if (static_cast<int>(card.getSuit()) != slot)
+        return false;
+
+    const Card& current = reserveSlots[slot];
+    if (!current.isValid())
+        return card.getRank() == Rank::Ace;
+    return card.getRank() > current.getRank();
+}
+
+std::vector<Move> Game::getLegalMoves(bool includeRecycle) const {
+    std::vector<Move> moves;
+
+    if (!deck.isEmpty()) {
+        moves.push_back({ MoveType::Draw, 0, 0, 0 });
+    }
+    else if (includeRecycle && !pile.empty()) {
+        moves.push_back({ MoveType::Recycle, 0, 0, 0 });
+    }
+
+    // each column check is one comparison with the top row of the tableau, bits come out in column order
+    Tableau tableau(*this);
+
+    if (!pile.empty()) {
+        const Card& card = pile.back();
+        for (unsigned mask = tableau.acceptMask(card); mask != 0; mask &= mask - 1) {
+            moves.push_back({ MoveType::PileToColumn, 0, static_cast<unsigned char>(std::countr_zero(mask)), 1 });
+        }
+        int slot = static_cast<int>(card.getSuit());
+        if (canPlaceOnReserve(card, slot))
+            moves.push_back({ MoveType::PileToReserve, 0, static_cast<unsigned char>(slot), 1 });
+    }
+
+    unsigned toReserve = tableau.foundationMask();
+    for (int from = 0; from < columnsSize; from++) {
+        if (toReserve & (1u << from)) {
+            int slot = static_cast<int>(columns[from].back().getSuit());
+            moves.push_back({ MoveType::ColumnToReserve, static_cast<unsigned char>(from), static_cast<unsigned char>(slot), 1 });
+        }
+
+        for (int count = 1; count <= tableau.getRunLength(from); count++) {
+            for (unsigned mask = tableau.acceptMask(from, count - 1); mask != 0; mask &= mask - 1) {
+                moves.push_back({ MoveType::ColumnToColumn, static_cast<unsigned char>(from), static_cast<unsigned char>(std::countr_zero(mask)), static_cast<unsigned char>(count) });
+            }
+        }
+    }
+
+    for (int slot = 0; slot < reserveSlotSize; slot++) {
+        const Card& card = reserveSlots[slot];
+        if (!card.isValid()) continue;
+
+        for (unsigned mask = tableau.acceptMask(card); mask != 0; mask &= mask - 1) {
+            moves.push_back({ MoveType::ReserveToColumn, static_cast<unsigned char>(slot), static_cast<unsigned char>(std::countr_zero(mask)), 1 });
+        }
+    }
+
+    return moves;
+}
+
+/// @brief Appends a card vector to a packed state as its size followed by one byte per card.
+static void packCards(std::string& out, const std::vector<Card>& cards) {
+    out.push_back(static_cast<char>(cards.size()));
+    for (const Card& card : cards) {
+        out.push_back(static_cast<char>(card.pack()));
+    }
+}
+
+/// @brief Reads a card vector written by packCards, advancing the position.
+/// @return False if the data ends too early.
+static bool unpackCards(const std::string& packed, size_t& pos, std::vector<Card>& cards) {
+    if (pos >= packed.size()) return false;
+    size_t size = static_cast<unsigned char>(packed[pos++]);
+    if (pos + size > packed.size()) return false;
+
+    cards.clear();
+    for (size_t i = 0; i < size; i++) {
+        cards.push_back(Card::unpack(static_cast<unsigned char>(packed[pos++])));
+    }
+    return true;
+}
+
+std::string Game::packState() const {
+    std::string out;
+    out.reserve(64 + columnsSize + reserveSlotSize);
+
+    packCards(out, deck.getCards());
+    packCards(out, pile);
+    for (int i = 0; i < columnsSize; i++) {
+        packCards(out, columns[i]);
+    }
+    for (int i = 0; i < reserveSlotSize; i++) {
+        out.push_back(static_cast<char>(reserveSlots[i].pack()));
+    }
+    return out;
+}
+
+std::string Game::packCanonicalState() const {
+    std::string packedColumns[columnsSize];
+    for (int i = 0; i < columnsSize; i++) {
+        packCards(packedColumns[i], columns[i]);
+    }
+    std::sort(std::begin(packedColumns), std::end(packedColumns));
+
+    std::string out;
+    out.reserve(64 + columnsSize + reserveSlotSize);
+
+    packCards(out, deck.getCards());
+    packCards(out, pile);
+    for (int i = 0; i < columnsSize; i++) {
+        out += packedColumns[i];
+    }
+    for (int i = 0; i < reserveSlotSize; i++) {
+        out.push_back(static_cast<char>(reserveSlots[i].pack()));
+    }
+    return out;
+}
+
+uint64_t Game::canonicalHash() const {
+    return hash64(packCanonicalState());
+}
+
+bool Game::unpackState(const std::string& packed) {
+    size_t pos = 0;
+    std::vector<Card> deckCards;
+    if (!unpackCards(packed, pos, deckCards)) return false;
+    if (!unpackCards(packed, pos, pile)) return false;
+    for (int i = 0; i < columnsSize; i++) {
+        if (!unpackCards(packed, pos, columns[i])) return false;
+    }
+    if (pos + reserveSlotSize != packed.size()) return false;
+    for (int i = 0; i < reserveSlotSize; i++) {
+        reserveSlots[i] = Card::unpack(static_cast<unsigned char>(packed[pos++]));
+    }
+
+    deck.setCards(deckCards);
+    currentCard = pile.empty() ? Card() : pile.back();
+    events.publish(placeChanged(GameEventType::GameReset, CardPlace::Deck, 0, Card()));
     return true;
 }
 
-bool Game::isGameWon()
+bool Game::isGameWon() const
 {
     int cnt = 0;
     for (int i = 0; i < 7; i++) {
-        auto& column = columns[i];
+        const auto& column = columns[i];
         if (column.size() != 13) continue;
 
         bool columnSet = true;
@@ -255,6 +459,7 @@ bool Game::saveFileGame(std::string name) {
         reserveSlots[i].writeCard(writer);
     }
     writer.flush();
+    return true;
 }
 bool Game::readFileGame(std::string name)
 {
@@ -298,6 +503,7 @@ bool Game::readFileGame(std::string name)
         reserveSlots[i].readCard(reader);
     }
 
+    events.publish(placeChanged(GameEventType::GameReset, CardPlace::Deck, 0, Card()));
     return true;
 }
 void Game::test()
@@ -328,6 +534,7 @@ void Game::test()
             suit++;
         }
     }
+    events.publish(placeChanged(GameEventType::GameReset, CardPlace::Deck, 0, Card()));
 }
 
 
@@ -2,7 +2,9 @@
 
 #include "Deck.hpp"
 #include "Card.hpp"
+#include "GameEvents.hpp"
 #include "util/common.hpp"
+#include <string>
 #include <vector>
 
 /**
@@ -10,6 +12,31 @@
  * @brief Declaration of the Game class for managing Solitaire game logic, including card columns, piles, and reserve slots.
  */
 
+/**
+ * @enum MoveType
+ * @brief Kinds of moves a player can make, one for each game command.
+ */
+enum class MoveType : unsigned char {
+    Draw,             ///< Draw a card from the deck to the pile.
+    ColumnToColumn,   ///< Move cards between columns.
+    PileToColumn,     ///< Move the top pile card to a column.
+    PileToReserve,    ///< Move the top pile card to a reserve slot.
+    ColumnToReserve,  ///< Move the top column card to a reserve slot.
+    ReserveToColumn,  ///< Move a reserve card back to a column.
+    Recycle           ///< Shuffle the pile back into the empty deck.
+};
+
+/**
+ * @struct Move
+ * @brief A single move, with indices meaning columns or reserve slots depending on the type.
+ */
+struct Move {
+    MoveType type;        ///< Kind of move.
+    unsigned char from;   ///< Source column or reserve slot, unused for pile and deck moves.
+    unsigned char to;     ///< Destination column or reserve slot.
+    unsigned char count;  ///< Number of cards moved, used by ColumnToColumn only.
+};
+
 /**
  * @class Game
  * @brief Manages the state and rules of a solitaire-like card game.
@@ -34,6 +61,12 @@ public:
      */
     void reset();
 
+    /**
+     * @brief Resets the game with a deck shuffled from the given seed, so the same seed always deals the same game.
+     * @param seed Seed of the deal.
+     */
+    void reset(unsigned int seed);
+
     /**
      * @brief Draws a card from the deck to the pile.
      * @return True if card can be drawn, false if deck is empty.
@@ -47,6 +80,13 @@ public:
      */
     std::vector<Card>& getColumn(int index);
 
+    /**
+     * @brief Gets a read-only reference to a column of cards.
+     * @param index Column index [0, columnsSize).
+     * @return Reference to vector of cards in that column.
+     */
+    const std::vector<Card>& getColumn(int index) const;
+
     /**
      * @brief Gets the current drawn card from the deck.
      * @return Reference to the current card.
@@ -73,6 +113,19 @@ public:
      */
     std::vector<Card>& getPile();
 
+    /**
+     * @brief Gets a read-only reference to the pile of drawn cards.
+     * @return Reference to vector of cards in the pile.
+     */
+    const std::vector<Card>& getPile() const;
+
+    /**
+     * @brief Gets a reserve slot card by index without allowing changes.
+     * @param index Reserve slot index [0, reserveSlotSize).
+     * @return Reference to the card in the reserve slot.
+     */
+    const Card& getReserveSlot(int index) const;
+
     /**
      * @brief Checks if the deck is empty
      * @return True if deck is empty, false otherwise.
@@ -118,7 +171,76 @@ public:
      */
     bool moveFromReserveToColumn(int slot, int toCol);
 
-    bool isGameWon();
+    /**
+     * @brief Checks if a card can be placed on top of a column.
+     * @param card Card to place.
+     * @param toCol Destination column index.
+     * @return True if the card fits on the column.
+     */
+    bool canPlaceOnColumn(const Card& card, int toCol) const;
+
+    /**
+     * @brief Checks if a card can be placed into a reserve slot.
+     * @param card Card to place.
+     * @param slot Reserve slot index.
+     * @return True if the card fits into the slot.
+     */
+    bool canPlaceOnReserve(const Card& card, int slot) const;
+
+    /**
+     * @brief Shuffles the pile back into the deck once every card was drawn.
+     * @return True if the pile was recycled, false if the deck still has cards or the pile is empty.
+     */
+    bool recycleStock();
+
+    /**
+     * @brief Applies a move by dispatching to the matching move method.
+     * @param move Move to apply.
+     * @return True if move succeeded, false otherwise.
+     */
+    bool applyMove(const Move& move);
+
+    /**
+     * @brief Lists every move that is legal in the current position.
+     * @param includeRecycle Whether to include recycling the pile, which reshuffles randomly.
+     * @return Vector of legal moves.
+     */
+    std::vector<Move> getLegalMoves(bool includeRecycle = false) const;
+
+    /**
+     * @brief Packs the whole game state into a compact byte string, one byte per card.
+     *
+     * Two games with equal packed states play identically, so the bytes can be hashed,
+     * sorted and compared by search code.
+     *
+     * @return Packed state.
+     */
+    std::string packState() const;
+
+    /**
+     * @brief Packs the game state in a normal form shared by all positions that differ only in column order.
+     *
+     * No rule depends on which column holds which cards, so the packed columns are sorted before
+     * being appended. The result is still a valid input for unpackState, with columns reordered.
+     *
+     * @return Canonical packed state.
+     */
+    std::string packCanonicalState() const;
+
+    /**
+     * @brief Hashes the canonical packed state, for transposition tables and visited sets.
+     * @return 64-bit hash of packCanonicalState.
+     */
+    uint64_t canonicalHash() const;
+
+    /**
+     * @brief Restores the game state from a string created by packState.
+     * @param packed Packed state.
+     * @return True if the state was restored, false if the data is malformed.
+     */
+    bool unpackState(const std::string& packed);
+
+    bool isGameWon() const;
 
     bool saveFileGame(std::string name);
 
@@ -128,15 +250,37 @@ public:
         return deck;
     }
 
+    inline const Deck& getDeck() const {
+        return deck;
+    }
+
+    /**
+     * @brief Gets the hub reporting every change made by the methods of this game.
+     *
+     * Changes made directly through the references returned by getColumn, getPile, getDeck and
+     * getReserveSlot are not reported.
+     *
+     * @return Event hub of this game, copies of the game start without subscribers.
+     */
+    inline GameEventHub& getEvents() {
+        return events;
+    }
+
     /**
    * @brief Sets up 4 slots of cards K-2 and puts 4 Aces into deck for development purpose
    */
     void test();
 
 private:
+    /**
+     * @brief Clears all columns, reserve slots and the pile, then deals a new game.
+     */
+    void dealNewGame();
+
     Deck deck;                                   ///< Deck of cards.
     Card currentCard;                            ///< Currently drawn card.
     std::vector<Card> columns[columnsSize];     ///< Tableau columns.
     std::vector<Card> pile;                      ///< Discard pile.
     Card reserveSlots[reserveSlotSize];          ///< Reserve slots.
+    GameEventHub events;                         ///< Subscribers to changes, last so an assignment reports the assigned state.
 };
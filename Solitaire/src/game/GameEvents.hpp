@@ -0,0 +1,136 @@
+#pragma once
+
+/**
+ * @file GameEvents.hpp
+ * @brief Declares the events Game reports for every change and the hub delivering them to subscribers.
+ */
+
+/**
+ * @enum GameEventType
+ * @brief Kinds of changes of a game.
+ */
+enum class GameEventType : unsigned char {
+    CardMoved,          ///< Cards went from one place to another.
+    CardFlipped,        ///< The top card of a column was turned face up.
+    FoundationChanged,  ///< A reserve slot got a new top card or was emptied.
+    StockRecycled,      ///< The pile was shuffled back into the empty deck.
+    GameReset           ///< The whole state was replaced: a new deal, a loaded save or an assignment.
+};
+
+/**
+ * @enum CardPlace
+ * @brief Places a card can be in, with an index for columns and reserve slots.
+ */
+enum class CardPlace : unsigned char {
+    Deck,     ///< Face-down deck.
+    Pile,     ///< Drawn cards.
+    Column,   ///< Tableau column.
+    Reserve   ///< Reserve slot, built up by suit like a foundation.
+};
+
+/**
+ * @struct GameEvent
+ * @brief One change of a game, a plain struct passed by reference to subscribers.
+ */
+struct GameEvent {
+    GameEventType type;        ///< Kind of change.
+    CardPlace from;            ///< Place the cards left, CardMoved only.
+    unsigned char fromIndex;   ///< Column or reserve slot the cards left.
+    CardPlace to;              ///< Place the cards went to, or the place that changed.
+    unsigned char toIndex;     ///< Column or reserve slot the cards went to or that changed.
+    unsigned char count;       ///< Number of cards moved.
+    unsigned char card;        ///< Card::pack of the first moved card, the flipped card or the new top of a slot.
+};
+
+/**
+ * @class GameEventHub
+ * @brief Delivers game events to a few subscribers, without allocating.
+ *
+ * Subscribers are a function pointer and a context pointer kept in a fixed array, so publishing
+ * an event is a loop over at most maxSubscribers calls, and a single branch when nobody listens,
+ * which keeps solvers applying millions of moves unaffected. Subscriptions belong to one game
+ * object: a copy starts without subscribers, and a game assigned to keeps its own subscribers,
+ * which are told the whole state was replaced.
+ */
+class GameEventHub {
+public:
+    /// Function called for every event, with the context given to subscribe.
+    using Listener = void (*)(const GameEvent& event, void* context);
+
+    /// Most subscribers one game can have.
+    static const int maxSubscribers = 4;
+
+    GameEventHub() = default;
+
+    /**
+     * @brief Creates a hub without subscribers, as subscriptions are not copied with a game.
+     */
+    GameEventHub(const GameEventHub&) {}
+
+    /**
+     * @brief Keeps the subscribers of this hub and reports GameReset to them.
+     *
+     * Game declares its hub as the last member, so the rest of the game is already assigned
+     * when the subscribers are called.
+     *
+     * @return This hub.
+     */
+    GameEventHub& operator=(const GameEventHub&) {
+        publish({ GameEventType::GameReset, CardPlace::Deck, 0, CardPlace::Deck, 0, 0, 0 });
+        return *this;
+    }
+
+    /**
+     * @brief Adds a subscriber.
+     * @param listener Function to call.
+     * @param context Passed to the function, usually the subscribing object.
+     * @return false if the hub is full.
+     */
+    bool subscribe(Listener listener, void* context) {
+        if (count == maxSubscribers) return false;
+        subscribers[count++] = { listener, context };
+        return true;
+    }
+
+    /**
+     * @brief Removes a subscriber added with the same listener and context.
+     * @param listener Function given to subscribe.
+     * @param context Context given to subscribe.
+     */
+    void unsubscribe(Listener listener, void* context) {
+        for (int i = 0; i < count; i++) {
+            if (subscribers[i].listener == listener && subscribers[i].context == context) {
+                subscribers[i] = subscribers[--count];
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Calls every subscriber with an event.
+     * @param event Change to report.
+     */
+    void publish(const GameEvent& event) const {
+        for (int i = 0; i < count; i++) {
+            subscribers[i].listener(event, subscribers[i].context);
+        }
+    }
+
+    /**
+     * @brief Checks if anybody listens.
+     * @return true without subscribers.
+     */
+    bool empty() const { return count == 0; }
+
+private:
+    /**
+     * @brief A subscribed function with its context.
+     */
+    struct Subscriber {
+        Listener listener;   ///< Function to call.
+        void* context;       ///< Passed to the function.
+    };
+
+    Subscriber subscribers[maxSubscribers];   ///< Subscribers, the first count are in use.
+    int count = 0;                            ///< Number of subscribers.
+};
@@ -0,0 +1,83 @@
+#include "Tableau.hpp"
+#include "Game.hpp"
+#include "util/simd.hpp"
+
+/// Rank in the top row of an empty column, one above King so that only a King matches it.
+static const uint8_t emptyRank = 14;
+
+/// Color in the top row of an empty column, equal to neither color so that both match it.
+static const uint8_t anyColor = 2;
+
+/// Suit in the top row of an empty column, equal to no reserve slot.
+static const uint8_t noSuit = 4;
+
+/// Lanes holding columns, the others are padding.
+static const unsigned columnLanes = (1u << Game::columnsSize) - 1;
+
+Tableau::Tableau(const Game& game) : faceUpMask(0) {
+    for (int lane = 0; lane < lanes; lane++) {
+        rank[0][lane] = 0;
+        color[0][lane] = 0;
+        topSuit[lane] = noSuit;
+        runLength[lane] = 0;
+        height[lane] = 0;
+    }
+
+    for (int column = 0; column < Game::columnsSize; column++) {
+        const std::vector<Card>& cards = game.getColumn(column);
+        height[column] = static_cast<uint8_t>(cards.size());
+        if (cards.empty()) {
+            rank[0][column] = emptyRank;
+            color[0][column] = anyColor;
+            continue;
+        }
+
+        const Card& top = cards.back();
+        rank[0][column] = static_cast<uint8_t>(top.getRank());
+        color[0][column] = top.isRed() ? 1 : 0;
+        topSuit[column] = static_cast<uint8_t>(top.getSuit());
+        if (!top.isFacingUp()) continue;
+
+        faceUpMask |= 1u << column;
+        int depth = 1;
+        for (; depth < static_cast<int>(cards.size()); depth++) {
+            const Card& card = cards[cards.size() - 1 - depth];
+            if (!card.isFacingUp()) break;
+            rank[depth][column] = static_cast<uint8_t>(card.getRank());
+            color[depth][column] = card.isRed() ? 1 : 0;
+        }
+        runLength[column] = static_cast<uint8_t>(depth);
+    }
+
+    for (int slot = 0; slot < Game::reserveSlotSize; slot++) {
+        const Card& card = game.getReserveSlot(slot);
+        // an empty slot takes only the Ace, a filled one any higher rank
+        reserveLow[slot] = card.isValid() ? static_cast<uint8_t>(static_cast<int>(card.getRank()) + 1) : 1;
+        reserveHigh[slot] = card.isValid() ? 13 : 1;
+    }
+}
+
+unsigned Tableau::acceptMask(const Card& card) const {
+    return acceptTops(static_cast<uint8_t>(card.getRank()), card.isRed() ? 1 : 0);
+}
+
+unsigned Tableau::acceptMask(int column, int depth) const {
+    return acceptTops(rank[depth][column], color[depth][column]) & ~(1u << column);
+}
+
+unsigned Tableau::acceptTops(uint8_t cardRank, uint8_t cardColor) const {
+    Simd::Bytes rankFits = Simd::equal(Simd::load(rank[0]), Simd::splat(static_cast<uint8_t>(cardRank + 1)));
+    Simd::Bytes sameColor = Simd::equal(Simd::load(color[0]), Simd::splat(cardColor));
+    return Simd::laneMask(Simd::butNot(rankFits, sameColor)) & columnLanes;
+}
+
+unsigned Tableau::foundationMask() const {
+    Simd::Bytes tops = Simd::load(rank[0]);
+    Simd::Bytes suits = Simd::load(topSuit);
+    Simd::Bytes fits = Simd::splat(0);
+    for (int slot = 0; slot < Game::reserveSlotSize; slot++) {
+        Simd::Bytes inRange = Simd::within(tops, Simd::splat(reserveLow[slot]), Simd::splat(reserveHigh[slot]));
+        fits = Simd::either(fits, Simd::both(Simd::equal(suits, Simd::splat(static_cast<uint8_t>(slot))), inRange));
+    }
+    return Simd::laneMask(fits) & faceUpMask;
+}
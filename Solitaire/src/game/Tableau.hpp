@@ -0,0 +1,95 @@
+#pragma once
+#include "Card.hpp"
+#include <cstdint>
+
+/**
+ * @file Tableau.hpp
+ * @brief Declares Tableau, a structure-of-arrays copy of the columns answering placement questions for all columns at once.
+ */
+
+class Game;
+
+/**
+ * @class Tableau
+ * @brief Ranks, colors and suits of the column cards laid out lane by lane, one lane per column.
+ *
+ * Row 0 holds the top card of every column, row 1 the card below it, and so on while the cards are
+ * face up, so the tops of all seven columns are one 16-byte row. Which columns accept a card and
+ * which tops fit their reserve slot are each answered by comparing whole rows at once with the
+ * Simd row operations, SSE2 where available, and returned as bit masks with bit i standing for
+ * column i. The rules are those of Game::canPlaceOnColumn and Game::canPlaceOnReserve.
+ *
+ * A tableau is a snapshot: it is filled from a game once and does not follow later moves.
+ */
+class Tableau {
+public:
+    static const int lanes = 16;        ///< Bytes in a row, columns beyond Game::columnsSize are padding.
+    static const int maxDepth = 52;     ///< Most cards a column can hold, as a column never holds more than the deck.
+
+    /**
+     * @brief Copies the columns and reserve slots of a game.
+     * @param game Game to copy.
+     */
+    explicit Tableau(const Game& game);
+
+    /**
+     * @brief Finds the columns a card can be placed on.
+     * @param card Card to place.
+     * @return Bit mask of accepting columns.
+     */
+    unsigned acceptMask(const Card& card) const;
+
+    /**
+     * @brief Finds the columns the card at some depth of a column can be moved to, with the cards above it.
+     * @param column Source column.
+     * @param depth Cards above the moved card, below getRunLength(column).
+     * @return Bit mask of accepting columns, without the source column.
+     */
+    unsigned acceptMask(int column, int depth) const;
+
+    /**
+     * @brief Finds the face-up column tops that fit their reserve slot.
+     * @return Bit mask of columns whose top can go to the reserve.
+     */
+    unsigned foundationMask() const;
+
+    /**
+     * @brief Gets the number of face-up cards on top of a column.
+     * @param column Column index.
+     * @return Face-up cards that can be moved, 0 for an empty column or a face-down top.
+     */
+    int getRunLength(int column) const { return runLength[column]; }
+
+    /**
+     * @brief Gets the number of cards in a column.
+     * @param column Column index.
+     * @return Cards in the column.
+     */
+    int getHeight(int column) const { return height[column]; }
+
+    /**
+     * @brief Gets the rank of a card counted from the top of a column.
+     * @param column Column index.
+     * @param depth Cards above it, below getRunLength(column) except for the top.
+     * @return Rank from 1 to 13.
+     */
+    int getRank(int column, int depth) const { return rank[depth][column]; }
+
+private:
+    /**
+     * @brief Compares a rank and color with the top row, the work shared by both acceptMask overloads.
+     * @param cardRank Rank of the placed card.
+     * @param cardColor 1 for a red card, 0 for a black one.
+     * @return Bit mask of accepting columns.
+     */
+    unsigned acceptTops(uint8_t cardRank, uint8_t cardColor) const;
+
+    alignas(16) uint8_t rank[maxDepth][lanes];   ///< Ranks by depth and column, row 0 holds emptyRank for empty columns.
+    alignas(16) uint8_t color[maxDepth][lanes];  ///< 1 for red and 0 for black by depth and column, anyColor for empty columns.
+    alignas(16) uint8_t topSuit[lanes];          ///< Suit of the top card, noSuit for empty columns.
+    uint8_t reserveLow[4];                       ///< Lowest rank each reserve slot accepts.
+    uint8_t reserveHigh[4];                      ///< Highest rank each reserve slot accepts.
+    uint8_t runLength[lanes];                    ///< Face-up cards on top of each column.
+    uint8_t height[lanes];                       ///< Cards in each column.
+    unsigned faceUpMask;                         ///< Columns with a face-up top.
+};
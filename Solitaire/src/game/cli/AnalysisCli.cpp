@@ -0,0 +1,474 @@
+#include "AnalysisCli.hpp"
+#include "RenderBench.hpp"
+#include "ShuffleTest.hpp"
+#include "../Game.hpp"
+#include "../solver/BatchRollout.hpp"
+#include "../solver/Certificate.hpp"
+#include "../solver/PortfolioSolver.hpp"
+#include "../solver/Solver.hpp"
+#include "../solver/StateExplorer.hpp"
+#include "../solver/Tuner.hpp"
+#include "../ui/DashboardUi.hpp"
+#include "../ui/ReplayViewer.hpp"
+#include "../util/colorUtil.hpp"
+#include "../util/perfCounters.hpp"
+#include "../util/terminalScreen.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// @brief Prints available analysis modes.
+static int printUsage() {
+    std::cout << "Uzycie:\n"
+        "  Solitaire --explore [ziarno] [max_glebokosc] [katalog] [pamiec_mb] [kanoniczne 1/0]\n"
+        "  Solitaire --solve [pierwsze_ziarno] [ilosc] [dfs/best/pns/portfolio] [max_wezlow] [max_przetasowan] [statystyki 1/0] [wagi/-] [plik_tablicy]\n"
+        "  Solitaire --verify [plik]\n"
+        "  Solitaire --tune [pierwsze_ziarno] [ilosc_gier] [rundy] [watki] [wagi]\n"
+        "  Solitaire --shuffle-test [ilosc_tasowan] [watki] [ziarniste 1/0]\n"
+        "  Solitaire --dashboard [ilosc_gier] [kafelki_w_rzedzie] [klatki_na_s] [klatki] [pierwsze_ziarno]\n"
+        "  Solitaire --replay ziarno certyfikat [predkosc/max] [klatki_na_s]\n"
+        "  Solitaire --bench [klatki] [ilosc_gier] [ziarno] [liczniki 1/0]\n"
+        "  Solitaire --rollouts [ilosc_gier] [losowa/zachlanna] [max_ruchow] [pierwsze_ziarno]\n";
+    return 1;
+}
+
+/// @brief Explores all states reachable from a seeded deal and prints the size of every layer.
+static int runExplore(const std::vector<std::string>& args) {
+    unsigned int seed = args.size() > 0 ? static_cast<unsigned int>(std::stoul(args[0])) : 0;
+    int maxDepth = args.size() > 1 ? std::stoi(args[1]) : -1;
+    std::string workDir = args.size() > 2 ? args[2] : "explore";
+    std::size_t memoryMb = args.size() > 3 ? std::stoul(args[3]) : 256;
+    bool canonical = args.size() > 4 ? args[4] != "0" : true;
+
+    Game game;
+    game.reset(seed);
+
+    StateExplorer explorer(workDir, memoryMb * 1024 * 1024, canonical);
+    explorer.explore(game, maxDepth, [](const StateExplorer::LayerReport& report) {
+        std::cout << "glebokosc " << report.depth
+            << " stany " << report.states
+            << " wygrane " << report.wonStates
+            << " odwiedzone " << report.visited << std::endl;
+    });
+    return 0;
+}
+
+/// @brief Solves a range of seeded deals and prints the result of each deal and a summary.
+static int runSolve(const std::vector<std::string>& args) {
+    unsigned int firstSeed = args.size() > 0 ? static_cast<unsigned int>(std::stoul(args[0])) : 0;
+    unsigned int count = args.size() > 1 ? static_cast<unsigned int>(std::stoul(args[1])) : 1;
+
+    SolverOptions options;
+    bool portfolio = args.size() > 2 && args[2] == "portfolio";
+    if (args.size() > 2 && !portfolio && !Solver::parseMode(args[2], options.mode)) {
+        std::cout << "Nieznany tryb solvera " << args[2] << "\n";
+        return 1;
+    }
+    if (args.size() > 3) options.maxNodes = std::stoull(args[3]);
+    if (args.size() > 4) options.maxRecycles = std::stoi(args[4]);
+    bool printStats = args.size() > 5 && args[5] != "0";
+    WeightedEvaluator::Weights weights;
+    if (args.size() > 6 && args[6] != "-" && !WeightedEvaluator::Weights::parse(args[6], weights)) {
+        std::cout << "Niepoprawne wagi " << args[6] << "\n";
+        return 1;
+    }
+    WeightedEvaluator evaluator(weights);
+    options.evaluator = &evaluator;
+    if (args.size() > 7) options.tablePath = args[7];
+
+    // one solver for the whole batch, so the proof-number table is shared by all deals
+    Solver solver(options);
+    if (!options.tablePath.empty() && !portfolio) {
+        switch (solver.getTableStatus()) {
+        case ProofNumberTable::FileStatus::Created: std::cout << "tablica: utworzono nowa\n"; break;
+        case ProofNumberTable::FileStatus::Reused:  std::cout << "tablica: wczytano\n"; break;
+        case ProofNumberTable::FileStatus::Stale:   std::cout << "tablica: nieaktualna, wyczyszczono\n"; break;
+        case ProofNumberTable::FileStatus::InUse:   std::cout << "tablica: plik uzywany przez inny proces, uzywam pamieci\n"; break;
+        default:
+            std::cout << (options.mode == SolverMode::ProofNumber
+                ? "tablica: nie mozna otworzyc pliku, uzywam pamieci\n"
+                : "tablica: uzywana tylko w trybie pns\n");
+            break;
+        }
+    }
+    if (printStats && !portfolio) {
+        // live progress goes to stderr so stdout stays one line per deal
+        solver.setProgressCallback([](const SolverStats& progress) {
+            std::cerr << "  wezly " << progress.nodes
+                << " wezly/s " << static_cast<uint64_t>(progress.nodesPerSecond())
+                << " pamiec " << progress.peakMemoryBytes / (1024 * 1024) << "MB" << std::endl;
+        });
+    }
+
+    unsigned int won = 0, lost = 0, unknown = 0, invalid = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int seed = firstSeed + i;
+        Game game;
+        game.reset(seed);
+
+        SolveResult result;
+        uint64_t nodes;
+        std::vector<Move> solution;
+        SolverStats stats;
+        if (portfolio) {
+            PortfolioSolver solver(options);
+            result = solver.solve(game);
+            nodes = solver.getNodeCount();
+            solution = solver.getSolution();
+            stats = solver.getStats();
+        }
+        else {
+            result = solver.solve(game);
+            nodes = solver.getNodeCount();
+            solution = solver.getSolution();
+            stats = solver.getStats();
+        }
+
+        // a win only counts once its certificate replays on a fresh deal
+        bool rejected = result == SolveResult::Won && !Certificate::verify(seed, solution);
+        if (rejected) {
+            invalid++;
+            result = SolveResult::Unknown;
+        }
+
+        switch (result) {
+        case SolveResult::Won:  won++; break;
+        case SolveResult::Lost: lost++; break;
+        default:                unknown++; break;
+        }
+
+        std::cout << "ziarno " << seed << " " << SearchUtil::resultName(result)
+            << " wezly " << nodes
+            << " ruchy " << solution.size();
+        if (result == SolveResult::Won) std::cout << " certyfikat " << Certificate::encode(solution);
+        if (rejected) std::cout << " certyfikat_odrzucony";
+        std::cout << std::endl;
+        if (printStats) std::cout << stats.toJson() << std::endl;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "wygrane " << won << " przegrane " << lost << " nieznane " << unknown
+        << " bledne_certyfikaty " << invalid << " czas " << seconds << "s\n";
+    return invalid == 0 ? 0 : 2;
+}
+
+/// @brief Tunes evaluator weights by self-play and prints the best weights after every round.
+static int runTune(const std::vector<std::string>& args) {
+    TuneOptions options;
+    if (args.size() > 0) options.firstSeed = static_cast<unsigned int>(std::stoul(args[0]));
+    if (args.size() > 1) options.games = static_cast<unsigned int>(std::stoul(args[1]));
+    if (args.size() > 2) options.rounds = std::stoi(args[2]);
+    if (args.size() > 3) options.threads = std::stoi(args[3]);
+
+    WeightedEvaluator::Weights start;
+    if (args.size() > 4 && !WeightedEvaluator::Weights::parse(args[4], start)) {
+        std::cout << "Niepoprawne wagi " << args[4] << "\n";
+        return 1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    Tuner tuner(options);
+    WeightedEvaluator::Weights best = tuner.tune(start, [](int round, double fitness, const WeightedEvaluator::Weights& weights) {
+        if (round == 0) std::cout << "start wynik " << fitness << " wagi " << weights.toString() << std::endl;
+        else std::cout << "runda " << round << " wynik " << fitness << " wagi " << weights.toString() << std::endl;
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "najlepsze wagi " << best.toString() << " czas " << seconds << "s\n";
+    return 0;
+}
+
+/// @brief Shuffles many decks on several threads and prints the speed and uniformity tests.
+static int runShuffleTest(const std::vector<std::string>& args) {
+    ShuffleTestOptions options;
+    if (args.size() > 0) options.shuffles = std::stoull(args[0]);
+    if (args.size() > 1) options.threads = std::stoi(args[1]);
+    if (args.size() > 2) options.seeded = args[2] != "0";
+
+    ShuffleTestReport report = ShuffleTest(options).run();
+    std::cout << "tasowania " << report.shuffles
+        << " czas " << report.seconds << "s"
+        << " tasowan/s " << static_cast<uint64_t>(report.shufflesPerSecond) << "\n"
+        << "pozycje chi2 " << report.positionChiSquare << " st_swobody " << report.positionDegrees
+        << " z " << report.positionScore << "\n"
+        << "pary chi2 " << report.pairChiSquare << " st_swobody " << report.pairDegrees
+        << " z " << report.pairScore << "\n"
+        << (report.passed ? "wynik: rownomierne" : "wynik: podejrzane") << std::endl;
+    return report.passed ? 0 : 2;
+}
+
+/// @brief Shows bots playing many games as tiles and reports how the renderer kept up.
+static int runDashboard(const std::vector<std::string>& args) {
+    DashboardOptions options;
+    if (args.size() > 0) options.games = std::stoi(args[0]);
+    if (args.size() > 1) options.tilesPerRow = std::stoi(args[1]);
+    if (args.size() > 2) options.fps = std::stoi(args[2]);
+    if (args.size() > 3) options.frames = std::stoi(args[3]);
+    if (args.size() > 4) options.firstSeed = static_cast<unsigned int>(std::stoul(args[4]));
+
+    DashboardUi dashboard(options);
+    DashboardReport report = dashboard.run();
+    double framesPerSecond = report.seconds > 0.0 ? report.frames / report.seconds : 0.0;
+    std::cout << "klatki " << report.frames << " czas " << report.seconds << "s"
+        << " klatek/s " << framesPerSecond
+        << " najdluzsza " << report.longestFrameMs << "ms"
+        << " ponad_budzet " << report.framesOverBudget << "\n"
+        << "kafelki przerysowane " << report.tilesDrawn << " pominiete " << report.tilesSkipped
+        << " bajty " << report.output.bytes << " sekwencje " << report.output.escapes
+        << " zmienione_komorki " << report.output.cellsChanged << "\n"
+        << "gry wygrane " << report.gamesWon << " przegrane " << report.gamesLost << std::endl;
+    return 0;
+}
+
+/// @brief Plays a certificate back on its deal at the chosen speed.
+static int runReplay(const std::vector<std::string>& args) {
+    if (args.size() < 2) return printUsage();
+    unsigned int seed = static_cast<unsigned int>(std::stoul(args[0]));
+    std::vector<Move> moves;
+    if (!Certificate::decode(args[1], moves)) {
+        std::cout << "Niepoprawny certyfikat\n";
+        return 1;
+    }
+
+    ReplayOptions options;
+    if (args.size() > 2) options.speed = args[2] == "max" ? 0.0 : std::stod(args[2]);
+    if (args.size() > 3) options.fps = std::stoi(args[3]);
+
+    ReplayReport report = ReplayViewer(options).play(seed, moves);
+    double movesPerSecond = report.seconds > 0.0 ? report.movesApplied / report.seconds : 0.0;
+    std::cout << "ruchy " << report.movesApplied << "/" << moves.size()
+        << " klatki " << report.framesDrawn << " pominiete_pozycje " << report.positionsSkipped
+        << " czas " << report.seconds << "s rysowanie " << report.drawSeconds << "s bajty " << report.output.bytes
+        << " ruchow/s " << static_cast<uint64_t>(movesPerSecond) << "\n";
+    if (report.illegalMove) std::cout << "niedozwolony ruch " << report.movesApplied + 1 << std::endl;
+    else std::cout << (report.won ? "wynik: wygrana" : "wynik: gra nieukonczona") << std::endl;
+    return report.illegalMove ? 2 : 0;
+}
+
+/**
+ * @brief Runs the render benchmarks and prints one JSON line per benchmark.
+ *
+ * The frames are drawn on the alternate screen, so the JSON lines are left on the normal screen;
+ * redirecting the output to a file keeps the escape sequences before them. Hardware counters
+ * are null where perf_event_open is missing or refused, as on Windows.
+ */
+static int runBench(const std::vector<std::string>& args) {
+    RenderBenchOptions options;
+    if (args.size() > 0) options.frames = std::stoi(args[0]);
+    if (args.size() > 1) options.games = std::stoi(args[1]);
+    if (args.size() > 2) options.seed = static_cast<unsigned int>(std::stoul(args[2]));
+    if (args.size() > 3) options.counters = args[3] != "0";
+
+    std::vector<RenderBenchResult> results = RenderBench(options).run();
+    for (const RenderBenchResult& result : results) {
+        std::cout << result.toJson() << "\n";
+    }
+    std::cout.flush();
+    return 0;
+}
+
+/**
+ * @brief Plays the games of a rollout batch one Game object after another, the baseline of --rollouts.
+ *
+ * Uses the policies of BatchRollout, the greedy one scoring copies of the game with the
+ * evaluator like GreedyBot does and taking the first of equally scored moves.
+ */
+static RolloutReport playOneByOne(const RolloutOptions& options, int games, unsigned int firstSeed) {
+    RolloutReport report{ games, 0, 0, 0, 0, 0, 0.0, 0.0 };
+    WeightedEvaluator evaluator(options.weights);
+    std::mt19937_64 random(options.randomSeed);
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < games; i++) {
+        Game game;
+        game.reset(firstSeed + i);
+        Move last{};
+        int moves = 0;
+
+        while (!game.isGameWon() && moves < options.maxSteps) {
+            std::vector<Move> legal = SearchUtil::searchMoves(game, options.maxRecycles);
+            if (legal.empty()) break;
+
+            Move chosen = legal[random() % legal.size()];
+            if (options.policy == RolloutPolicy::Greedy) {
+                int bestScore = 0;
+                bool found = false;
+                for (const Move& move : legal) {
+                    if (moves > 0 && SearchUtil::undoes(move, last)) continue;
+                    Game child = game;
+                    child.applyMove(move);
+                    int score = evaluator.evaluate(child);
+                    if (!found || score > bestScore) {
+                        chosen = move;
+                        bestScore = score;
+                        found = true;
+                    }
+                }
+            }
+            game.applyMove(chosen);
+            last = chosen;
+            moves++;
+        }
+
+        report.moves += moves;
+        report.steps = (std::max)(report.steps, moves);
+        if (game.isGameWon()) report.won++;
+        else if (moves >= options.maxSteps) report.outOfSteps++;
+        else report.stuck++;
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.movesPerSecond = report.seconds > 0.0 ? report.moves / report.seconds : 0.0;
+    return report;
+}
+
+/// @brief Prints one line of rollout results, with the hardware counts per move when they were read.
+static void printRollouts(const char* name, const RolloutReport& report, const PerfCounters::Sample& sample) {
+    std::cout << name << " gry " << report.games
+        << " wygrane " << report.won << " zablokowane " << report.stuck << " limit " << report.outOfSteps
+        << " ruchy " << report.moves << " czas " << report.seconds << "s"
+        << " ruchow/s " << static_cast<uint64_t>(report.movesPerSecond);
+
+    static const char* const names[PerfCounters::counterCount] = { "cykle", "instrukcje", "chybienia_cache", "bledne_skoki" };
+    double moves = report.moves > 0 ? static_cast<double>(report.moves) : 1.0;
+    for (int i = 0; i < PerfCounters::counterCount; i++) {
+        if (sample.values[i] >= 0) std::cout << " " << names[i] << "/ruch " << sample.values[i] / moves;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Plays seeded deals as one BatchRollout batch and then one game at a time, and compares the speed.
+ */
+static int runRollouts(const std::vector<std::string>& args) {
+    int games = args.size() > 0 ? std::stoi(args[0]) : 4096;
+    RolloutOptions options;
+    if (args.size() > 1) {
+        if (args[1] == "zachlanna") options.policy = RolloutPolicy::Greedy;
+        else if (args[1] != "losowa") return printUsage();
+    }
+    if (args.size() > 2) options.maxSteps = std::stoi(args[2]);
+    unsigned int firstSeed = args.size() > 3 ? static_cast<unsigned int>(std::stoul(args[3])) : 0;
+    if (games < 1) return printUsage();
+
+    BatchRollout batch(games, options);
+    for (int i = 0; i < games; i++) {
+        batch.deal(i, firstSeed + i);
+    }
+    PerfCounters counters;
+    counters.open();
+    counters.start();
+    RolloutReport batched = batch.run();
+    printRollouts("wsadowo", batched, counters.stop());
+
+    counters.start();
+    RolloutReport looped = playOneByOne(options, games, firstSeed);
+    printRollouts("po_kolei", looped, counters.stop());
+    if (looped.movesPerSecond > 0.0) {
+        std::cout << "przyspieszenie " << batched.movesPerSecond / looped.movesPerSecond << "x" << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief Verifies certificates from a file or standard input.
+ *
+ * Accepts the lines printed by --solve, where the seed follows "ziarno" and the moves follow
+ * "certyfikat", as well as plain "seed moves" lines. Lines without a certificate are skipped.
+ */
+static int runVerify(const std::vector<std::string>& args) {
+    std::ifstream file;
+    if (args.size() > 0) {
+        file.open(args[0]);
+        if (!file.is_open()) {
+            std::cout << "Nie mozna otworzyc pliku " << args[0] << "\n";
+            return 1;
+        }
+    }
+    std::istream& in = args.size() > 0 ? static_cast<std::istream&>(file) : std::cin;
+
+    unsigned int valid = 0, invalid = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::string line;
+    std::vector<Move> moves;
+
+    while (std::getline(in, line)) {
+        std::istringstream tokens(line);
+        std::vector<std::string> words;
+        for (std::string word; tokens >> word;) words.push_back(word);
+
+        std::string seedText, certificate;
+        if (words.size() >= 2 && words[0] == "ziarno") {
+            seedText = words[1];
+            for (std::size_t i = 2; i + 1 < words.size(); i++) {
+                if (words[i] == "certyfikat") certificate = words[i + 1];
+            }
+        }
+        else if (words.size() == 2) {
+            seedText = words[0];
+            certificate = words[1];
+        }
+        if (certificate.empty()) continue;
+
+        // a malformed seed counts against its own line only, the rest of the file is still verified
+        unsigned long long parsedSeed = 0;
+        bool seedValid = true;
+        try {
+            parsedSeed = std::stoull(seedText);
+        }
+        catch (const std::logic_error&) {
+            seedValid = false;
+        }
+        if (!seedValid || parsedSeed > 0xFFFFFFFFull) {
+            invalid++;
+            std::cout << "bledne ziarno " << seedText << std::endl;
+            continue;
+        }
+
+        unsigned int seed = static_cast<unsigned int>(parsedSeed);
+        if (Certificate::decode(certificate, moves) && Certificate::verify(seed, moves)) {
+            valid++;
+        }
+        else {
+            invalid++;
+            std::cout << "bledny certyfikat ziarno " << seed << std::endl;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "poprawne " << valid << " bledne " << invalid << " czas " << seconds << "s\n";
+    return invalid == 0 ? 0 : 2;
+}
+
+int AnalysisCli::run(int argc, char* argv[]) {
+    if (argc < 2) return printUsage();
+
+    std::string mode = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+    ColorUtil::setColorMode(ColorUtil::detectColorMode());
+    TerminalScreen::setSynchronizedOutput(TerminalScreen::detectSynchronizedOutput());
+
+    try {
+        if (mode == "--explore") return runExplore(args);
+        if (mode == "--solve") return runSolve(args);
+        if (mode == "--verify") return runVerify(args);
+        if (mode == "--tune") return runTune(args);
+        if (mode == "--shuffle-test") return runShuffleTest(args);
+        if (mode == "--dashboard") return runDashboard(args);
+        if (mode == "--replay") return runReplay(args);
+        if (mode == "--bench") return runBench(args);
+        if (mode == "--rollouts") return runRollouts(args);
+    }
+    catch (const std::exception&) {
+        std::cout << "Niepoprawne argumenty\n";
+    }
+    return printUsage();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * @file AnalysisCli.hpp
+ * @brief Declares the command line entry point for analysis modes that run without the console UI.
+ */
+
+/**
+ * @namespace AnalysisCli
+ * @brief Parses program arguments and runs the requested analysis mode.
+ */
+namespace AnalysisCli {
+
+    /**
+     * @brief Runs the analysis mode selected by the program arguments.
+     *
+     * Supported modes:
+     *
+     * - "--explore [seed] [max_depth] [work_dir] [memory_mb] [canonical]"
+     *   Breadth-first exploration of every state reachable from the deal, printing layer sizes.
+     *   max_depth: last explored depth, -1 for no limit (default -1)
+     *   work_dir: directory for temporary layer files (default "explore")
+     *   memory_mb: memory budget for sorting (default 256)
+     *   canonical: 0 to count column permutations as distinct states (default 1)
+     *
+     * - "--solve [first_seed] [count] [mode] [max_nodes] [max_recycles] [stats] [weights] [table_path]"
+     *   Batch analysis of consecutive seeded deals, printing the result of each deal.
+     *   mode: "dfs" depth-first, "best" best-first, "pns" proof-number search or
+     *         "portfolio" racing all three on separate threads (default "dfs")
+     *   max_nodes: positions expanded per deal before giving up (default 2000000)
+     *   max_recycles: pile recycles allowed in a solution (default 2)
+     *   stats: 1 to print the search statistics of every deal as JSON (default 0)
+     *   weights: comma-separated evaluator weights of best-first search, "-" for the defaults
+     *   table_path: file keeping the proof-number table between runs (default in memory)
+     *
+     * - "--verify [file]"
+     *   Replays certificates printed by --solve, or "seed moves" lines, read from the file
+     *   or standard input, and counts valid and invalid ones.
+     *
+     * - "--tune [first_seed] [games] [rounds] [threads] [weights]"
+     *   Self-play search for evaluator weights, printing the best weights after every round.
+     *   games: deals played with every weight vector (default 200)
+     *   rounds: rounds of the search (default 20)
+     *   threads: worker threads, 0 for one per hardware thread (default 0)
+     *   weights: comma-separated starting weights (default built-in weights)
+     *
+     * - "--shuffle-test [shuffles] [threads] [seeded]"
+     *   Shuffles many decks on several threads, printing the speed and chi-square uniformity tests.
+     *   shuffles: deals over all threads (default 10000000)
+     *   threads: worker threads, 0 for one per hardware thread (default 0)
+     *   seeded: 0 to test std::random_device shuffles instead of seeded deals (default 1)
+     *
+     * - "--dashboard [games] [tiles_per_row] [fps] [frames] [first_seed]"
+     *   Greedy bots playing several games at once, each drawn as a tile, and a frame report.
+     *   games: number of tiles (default 12)
+     *   tiles_per_row: tiles in one row of the grid (default 4)
+     *   fps: frames per second, 0 draws frames back to back (default 60)
+     *   frames: frames drawn before the run ends (default 600)
+     *
+     * - "--replay seed certificate [speed] [fps]"
+     *   Plays a certificate back on the deal of the seed, skipping positions a frame cannot show.
+     *   speed: speed multiplier or "max" for as fast as possible (default 1)
+     *   fps: most frames drawn per second (default 60)
+     *
+     * - "--bench [frames] [games] [seed] [counters]"
+     *   Draws frames with every renderer as fast as possible, printing one JSON line per benchmark.
+     *   frames: frames drawn by every benchmark (default 300)
+     *   games: tiles of the dashboard benchmark (default 12)
+     *   seed: deal of the board benchmarks and first deal of the dashboard (default 0)
+     *   counters: 0 to skip reading hardware counters (default 1)
+     *
+     * - "--rollouts [games] [policy] [max_moves] [first_seed]"
+     *   Plays many games at once in the batch rollout engine and compares it with one-by-one play.
+     *   games: games played (default 4096)
+     *   policy: "losowa" random or "zachlanna" greedy moves (default "losowa")
+     *   max_moves: moves per game before it stops (default 400)
+     *
+     * @param argc Argument count as passed to main.
+     * @param argv Argument values as passed to main.
+     * @return Process exit code.
+     */
+    int run(int argc, char* argv[]);
+}
@@ -0,0 +1,91 @@
+#include "RenderBench.hpp"
+#include "../Game.hpp"
+#include "../solver/Evaluator.hpp"
+#include "../solver/GreedyBot.hpp"
+#include "../ui/ConsoleUi.hpp"
+#include "../ui/DashboardUi.hpp"
+#include "../ui/TileRenderer.hpp"
+#include "../util/colorUtil.hpp"
+#include "../util/terminalScreen.hpp"
+#include <chrono>
+#include <sstream>
+
+/// Pile recycles the board benchmark bot may use.
+static const int benchRecycles = 3;
+
+std::string RenderBenchResult::toJson() const {
+    std::ostringstream out;
+    out << "{\"benchmark\":\"" << name << "\""
+        << ",\"frames\":" << frames
+        << ",\"seconds\":" << seconds
+        << ",\"frames_per_second\":" << (seconds > 0.0 ? frames / seconds : 0.0)
+        << ",\"output\":" << meter.toJson()
+        << ",\"counters\":" << counters.toJson()
+        << "}";
+    return out.str();
+}
+
+RenderBench::RenderBench(const RenderBenchOptions& options) : options(options) {}
+
+std::vector<RenderBenchResult> RenderBench::run() {
+    if (options.counters) counters.open();
+
+    std::vector<RenderBenchResult> results;
+    results.push_back(runBoard("board_full", false, false));
+    results.push_back(runBoard("board_compact", true, false));
+    results.push_back(runBoard("board_changes", false, true));
+    results.push_back(runDashboard());
+    counters.close();
+    return results;
+}
+
+RenderBenchResult RenderBench::runBoard(const std::string& name, bool compact, bool changesOnly) {
+    Game game;
+    game.reset(options.seed);
+    WeightedEvaluator evaluator;
+    GreedyBot bot(evaluator, benchRecycles);
+    bot.reset(game);
+
+    ConsoleUi ui(game);
+    ui.setCardLayout(compact ? ConsoleUi::CardLayout::Compact : ConsoleUi::CardLayout::Full);
+    TileRenderer::write(TerminalScreen::enterAlternateScreen + TerminalScreen::clearScreen);
+
+    counters.start();
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < options.frames; frame++) {
+        // a finished game starts over, so every frame shows a position after a move; the bot plays
+        // through Game::applyMove, so the canvas sees the move and flip events a player's move makes
+        if (game.isGameWon() || !bot.step(game)) {
+            game.reset(options.seed + frame + 1);
+            bot.reset(game);
+        }
+        if (changesOnly) {
+            // the game screen as the render thread draws it, synchronized update included
+            ui.drawChanges();
+            continue;
+        }
+        TileRenderer::write(TerminalScreen::beginFrame());
+        ui.draw();
+        TileRenderer::write(TerminalScreen::endFrame());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    PerfCounters::Sample sample = counters.stop();
+    TileRenderer::write(ColorUtil::RESET + TerminalScreen::leaveAlternateScreen);
+
+    return RenderBenchResult{ name, options.frames, seconds, ui.getFrameMeter(), sample };
+}
+
+RenderBenchResult RenderBench::runDashboard() {
+    DashboardOptions dashboardOptions;
+    dashboardOptions.games = options.games;
+    dashboardOptions.fps = 0;
+    dashboardOptions.frames = options.frames;
+    dashboardOptions.firstSeed = options.seed;
+
+    DashboardUi dashboard(dashboardOptions);
+    counters.start();
+    DashboardReport report = dashboard.run();
+    PerfCounters::Sample sample = counters.stop();
+
+    return RenderBenchResult{ "dashboard", report.frames, report.seconds, dashboard.getFrameMeter(), sample };
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "../ui/FrameMeter.hpp"
+#include "../util/perfCounters.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @file RenderBench.hpp
+ * @brief Declares the RenderBench class which measures the terminal output of the renderers.
+ */
+
+/**
+ * @struct RenderBenchOptions
+ * @brief Length of a benchmark run.
+ */
+struct RenderBenchOptions {
+    int frames = 300;            ///< Frames drawn by every benchmark.
+    int games = 12;              ///< Tiles of the dashboard benchmark.
+    unsigned int seed = 0;       ///< Seed of the board benchmarks and of the first dashboard deal.
+    bool counters = true;        ///< Whether to read hardware counters around every benchmark where the system offers them.
+};
+
+/**
+ * @struct RenderBenchResult
+ * @brief Speed and output of one benchmark.
+ */
+struct RenderBenchResult {
+    std::string name;           ///< Benchmark name used in the JSON output.
+    int frames;                 ///< Frames drawn.
+    double seconds;             ///< Wall-clock time of the benchmark.
+    FrameMeter meter;           ///< Output of the frames.
+    PerfCounters::Sample counters; ///< Hardware counts of the benchmark, unavailable when not read.
+
+    /**
+     * @brief Formats the result as one JSON object.
+     * @return JSON text without a trailing newline.
+     */
+    std::string toJson() const;
+};
+
+/**
+ * @class RenderBench
+ * @brief Draws frames as fast as possible with every renderer and meters what they write.
+ *
+ * The board benchmarks draw the full and the compact layout of ConsoleUi while a bot plays a
+ * move between frames, whole and as the game screen draws only what a move changed; the dashboard benchmark runs DashboardUi unpaced. Frames go to the real
+ * terminal, so flush times include the terminal and the numbers of different runs compare only
+ * on the same terminal. Where the system allows it, cycles, instructions, cache and branch misses
+ * of the drawing thread are counted too; they show what a change of the data layout did even
+ * when the terminal hides it in the wall-clock time.
+ */
+class RenderBench {
+public:
+    /**
+     * @brief Creates a benchmark run.
+     * @param options Length of the run.
+     */
+    explicit RenderBench(const RenderBenchOptions& options = RenderBenchOptions());
+
+    /**
+     * @brief Runs all benchmarks.
+     * @return Results in the order they ran.
+     */
+    std::vector<RenderBenchResult> run();
+
+private:
+    /**
+     * @brief Draws the board with a fixed card layout.
+     * @param name Benchmark name.
+     * @param compact True for the compact layout.
+     * @param changesOnly True to draw only the changes of every move, as the game screen does,
+     *        false to draw the whole board every frame.
+     * @return Benchmark result.
+     */
+    RenderBenchResult runBoard(const std::string& name, bool compact, bool changesOnly);
+
+    /**
+     * @brief Runs the dashboard without frame pacing.
+     * @return Benchmark result.
+     */
+    RenderBenchResult runDashboard();
+
+    RenderBenchOptions options; ///< Length of the run.
+    PerfCounters counters;      ///< Hardware counters, open for the run if requested and offered.
+};
@@ -0,0 +1,123 @@
+#include "ShuffleTest.hpp"
+#include "../Deck.hpp"
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+/// Number of cards in a deck.
+static const int deckSize = 52;
+
+/**
+ * @brief Per-thread counters.
+ */
+struct ShuffleCounts {
+    std::vector<uint64_t> positions = std::vector<uint64_t>(deckSize * deckSize, 0); ///< [card * deckSize + position]
+    std::vector<uint64_t> pairs = std::vector<uint64_t>(deckSize * deckSize, 0);     ///< [lower card * deckSize + upper card]
+};
+
+/// @brief Gets the index [0, 52) of a card regardless of its facing.
+static int cardIndex(const Card& card) {
+    return card.pack() & 0x3F;
+}
+
+/**
+ * @brief Deals the given number of decks and counts card positions and adjacent pairs.
+ *
+ * Every deal is a fresh deck, ordered and shuffled once exactly as a new game does, so the test
+ * measures the deals players get and no bias of the ordered deck can hide behind earlier shuffles.
+ */
+static void shuffleAndCount(const ShuffleTestOptions& options, unsigned int firstSeed, uint64_t shuffles, ShuffleCounts& counts) {
+    int cards[deckSize];
+
+    for (uint64_t i = 0; i < shuffles; i++) {
+        Deck deck = options.seeded ? Deck(firstSeed + static_cast<unsigned int>(i)) : Deck();
+        const std::vector<Card>& deckCards = deck.getCards();
+        for (int position = 0; position < deckSize; position++) {
+            cards[position] = cardIndex(deckCards[position]);
+            counts.positions[cards[position] * deckSize + position]++;
+        }
+        for (int position = 1; position < deckSize; position++) {
+            counts.pairs[cards[position - 1] * deckSize + cards[position]]++;
+        }
+    }
+}
+
+ShuffleTest::ShuffleTest(const ShuffleTestOptions& options) : options(options) {}
+
+double ShuffleTest::normalScore(double chiSquare, double degrees) {
+    double k = degrees;
+    double variance = 2.0 / (9.0 * k);
+    return (std::cbrt(chiSquare / k) - (1.0 - variance)) / std::sqrt(variance);
+}
+
+ShuffleTestReport ShuffleTest::run() {
+    int threadCount = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount < 1) threadCount = 1;
+
+    std::vector<ShuffleCounts> counts(threadCount);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    // threads deal consecutive ranges of seeds, so no deal is counted twice
+    uint64_t firstShuffle = 0;
+    for (int i = 0; i < threadCount; i++) {
+        uint64_t shuffles = options.shuffles / threadCount + (static_cast<uint64_t>(i) < options.shuffles % threadCount ? 1 : 0);
+        unsigned int firstSeed = options.seed + static_cast<unsigned int>(firstShuffle);
+        threads.emplace_back(shuffleAndCount, std::cref(options), firstSeed, shuffles, std::ref(counts[i]));
+        firstShuffle += shuffles;
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    ShuffleTestReport report{};
+    report.shuffles = options.shuffles;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.shufflesPerSecond = report.seconds > 0.0 ? options.shuffles / report.seconds : 0.0;
+
+    ShuffleCounts total;
+    for (const ShuffleCounts& threadCounts : counts) {
+        for (int i = 0; i < deckSize * deckSize; i++) {
+            total.positions[i] += threadCounts.positions[i];
+            total.pairs[i] += threadCounts.pairs[i];
+        }
+    }
+
+    // every card is expected equally often on every position; the cells of a permutation count
+    // are tied by fixed row and column sums, which makes Pearson's sum n/(n-1) times chi-square
+    // with (n-1)^2 degrees of freedom
+    double n = static_cast<double>(deckSize);
+    double positionExpected = static_cast<double>(options.shuffles) / deckSize;
+    double positionSum = 0.0;
+    for (uint64_t observed : total.positions) {
+        double difference = observed - positionExpected;
+        positionSum += difference * difference / positionExpected;
+    }
+    report.positionDegrees = (n - 1.0) * (n - 1.0);
+    report.positionChiSquare = positionSum * (n - 1.0) / n;
+
+    // every ordered pair of different cards is expected equally often among the 51 adjacent pairs;
+    // pairs sharing a card exclude or favour each other within a deal, so Pearson's sum has mean
+    // (n-1)^2 and variance 2(n^2-n-1), and is matched to chi-square scaled by the ratio of the two
+    double pairExpected = static_cast<double>(options.shuffles) / deckSize;
+    double pairSum = 0.0;
+    for (int lower = 0; lower < deckSize; lower++) {
+        for (int upper = 0; upper < deckSize; upper++) {
+            if (lower == upper) continue;
+            double difference = total.pairs[lower * deckSize + upper] - pairExpected;
+            pairSum += difference * difference / pairExpected;
+        }
+    }
+    double pairMean = (n - 1.0) * (n - 1.0);
+    double pairHalfVariance = n * n - n - 1.0;
+    report.pairDegrees = pairMean * pairMean / pairHalfVariance;
+    report.pairChiSquare = pairSum * pairMean / pairHalfVariance;
+
+    report.positionScore = normalScore(report.positionChiSquare, report.positionDegrees);
+    report.pairScore = normalScore(report.pairChiSquare, report.pairDegrees);
+    report.passed = options.shuffles > 0
+        && std::fabs(report.positionScore) < scoreLimit
+        && std::fabs(report.pairScore) < scoreLimit;
+    return report;
+}
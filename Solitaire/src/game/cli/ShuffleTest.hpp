@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @file ShuffleTest.hpp
+ * @brief Declares the ShuffleTest class which measures the speed and uniformity of Deck::shuffle.
+ */
+
+/**
+ * @struct ShuffleTestOptions
+ * @brief Size and kind of a shuffle test run.
+ */
+struct ShuffleTestOptions {
+    uint64_t shuffles = 10000000; ///< Deals over all threads.
+    int threads = 0;              ///< Worker threads, 0 for one per hardware thread.
+    bool seeded = true;           ///< Test seeded shuffles used for deals, otherwise std::random_device shuffles.
+    unsigned int seed = 1;        ///< Seed of the first deal, following deals use the next seeds.
+};
+
+/**
+ * @struct ShuffleTestReport
+ * @brief Speed and test statistics of a run.
+ *
+ * Both tests sum Pearson's terms over count cells that are not independent, so each sum is first
+ * scaled to the chi-square distribution it follows for a fair shuffle and then converted to a
+ * standard normal score with the Wilson-Hilferty approximation. A fair shuffle gives scores
+ * close to zero, spread with deviation one, whatever the number of shuffles.
+ */
+struct ShuffleTestReport {
+    uint64_t shuffles;          ///< Shuffles done.
+    double seconds;             ///< Wall-clock time of the run.
+    double shufflesPerSecond;   ///< Shuffles per second over all threads.
+    double positionChiSquare;   ///< Scaled chi-square of how often every card lands on every position.
+    double positionDegrees;     ///< Degrees of freedom of the position test.
+    double positionScore;       ///< Normal score of the position test.
+    double pairChiSquare;       ///< Scaled chi-square of how often every card lies directly on every other card.
+    double pairDegrees;         ///< Effective degrees of freedom of the pair test.
+    double pairScore;           ///< Normal score of the pair test.
+    bool passed;                ///< True if both scores are within the acceptance limit.
+};
+
+/**
+ * @class ShuffleTest
+ * @brief Deals many decks on several threads and tests that deals stay uniform.
+ *
+ * Every deal is a new deck shuffled once, as Game::reset deals it. Every thread has its own
+ * counters, which are merged only when all threads are done, so the threads never share memory
+ * while shuffling.
+ */
+class ShuffleTest {
+public:
+    /// Largest absolute normal score accepted as uniform.
+    static constexpr double scoreLimit = 4.0;
+
+    /**
+     * @brief Creates a test run.
+     * @param options Size and kind of the run.
+     */
+    explicit ShuffleTest(const ShuffleTestOptions& options = ShuffleTestOptions());
+
+    /**
+     * @brief Runs the shuffles and computes the statistics.
+     * @return Test report.
+     */
+    ShuffleTestReport run();
+
+    /**
+     * @brief Converts a chi-square value to a standard normal score.
+     * @param chiSquare Chi-square statistic.
+     * @param degrees Degrees of freedom, not necessarily whole.
+     * @return Normal score, positive when the counts are less uniform than expected.
+     */
+    static double normalScore(double chiSquare, double degrees);
+
+private:
+    ShuffleTestOptions options; ///< Size and kind of the run.
+};
@@ -0,0 +1,550 @@
+#include "BatchRollout.hpp"
+#include "SearchUtil.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+/// First slot of every kind of move; a game's legal moves are a set of slots.
+static const int drawSlot = 0;               ///< Draw, or Recycle when the deck is empty.
+static const int pileToColumnSlot = 1;       ///< Plus the column.
+static const int pileToReserveSlot = 8;      ///< The slot of the pile card's suit.
+static const int columnToReserveSlot = 9;    ///< Plus the column.
+static const int columnToColumnSlot = 16;    ///< Plus source * 7 + destination.
+static const int reserveToColumnSlot = 65;   ///< Plus reserve slot * 7 + column.
+
+/// Top row values of an empty column, chosen like those of Tableau: only a King fits rank 14 and both colors differ from 2.
+static const uint8_t emptyRank = 14;
+static const uint8_t anyColor = 2;
+static const uint8_t noSuit = 4;
+
+/// Face-up bit of a Card::pack byte.
+static const uint8_t faceUpBit = 0x40;
+
+/// @brief Gets the rank of a packed card.
+static inline uint8_t rankOf(uint8_t card) { return static_cast<uint8_t>((card & 0x3F) % 13 + 1); }
+
+/// @brief Gets the suit of a packed card.
+static inline uint8_t suitOf(uint8_t card) { return static_cast<uint8_t>((card & 0x3F) / 13); }
+
+/// @brief Gets the color row value of a suit, 1 for Hearts and Diamonds.
+static inline uint8_t colorOf(uint8_t suit) { return suit < 2 ? 1 : 0; }
+
+BatchRollout::BatchRollout(int games, const RolloutOptions& options)
+    : options(options), games(games), groups((games + groupSize - 1) / groupSize), cards(games),
+    moveSets(groups.size() * groupSize), randomState(options.randomSeed) {
+}
+
+void BatchRollout::deal(int lane, unsigned int seed) {
+    Game game;
+    game.reset(seed);
+    load(lane, game);
+}
+
+bool BatchRollout::load(int lane, const Game& game) {
+    LaneGroup& group = groups[lane / groupSize];
+    int i = lane % groupSize;
+    LaneCards& lc = cards[lane];
+    lc = LaneCards();
+    group.playing[i] = 0;
+
+    for (int column = 0; column < Game::columnsSize; column++) {
+        const std::vector<Card>& source = game.getColumn(column);
+        if (source.size() > static_cast<std::size_t>(maxColumnCards)) return false;
+
+        int run = 0;
+        for (std::size_t j = 0; j < source.size(); j++) {
+            const Card& card = source[j];
+            lc.columns[column][j] = card.pack();
+            if (!card.isFacingUp()) {
+                if (run > 0) return false;
+                continue;
+            }
+            // a face-up card must continue the alternating run below it
+            if (run > 0) {
+                const Card& below = source[j - 1];
+                if (below.isRed() == card.isRed() || static_cast<int>(below.getRank()) != static_cast<int>(card.getRank()) + 1) return false;
+            }
+            run++;
+        }
+        group.height[column][i] = static_cast<uint8_t>(source.size());
+        group.run[column][i] = static_cast<uint8_t>(run);
+        refreshColumn(lane, column);
+    }
+
+    const std::vector<Card>& deck = game.getDeck().getCards();
+    for (std::size_t j = 0; j < deck.size(); j++) lc.deck[j] = deck[j].pack();
+    group.deckCount[i] = static_cast<uint8_t>(deck.size());
+
+    const std::vector<Card>& pile = game.getPile();
+    for (std::size_t j = 0; j < pile.size(); j++) lc.pile[j] = pile[j].pack();
+    group.pileCount[i] = static_cast<uint8_t>(pile.size());
+    refreshPile(lane);
+
+    for (int slot = 0; slot < Game::reserveSlotSize; slot++) {
+        const Card& card = game.getReserveSlot(slot);
+        group.reserveRank[slot][i] = card.isValid() ? static_cast<uint8_t>(card.getRank()) : 0;
+    }
+
+    lc.seeded = game.getDeck().isSeeded();
+    lc.seed = game.getDeck().getSeed();
+    lc.shuffleCount = game.getDeck().getShuffleCount();
+    group.recyclesLeft[i] = static_cast<uint8_t>(std::max(0, options.maxRecycles - SearchUtil::recycleCount(game)));
+
+    if (game.isGameWon()) {
+        lc.status = RolloutStatus::Won;
+        return true;
+    }
+    lc.status = RolloutStatus::Playing;
+    group.playing[i] = 0xFF;
+    return true;
+}
+
+void BatchRollout::refreshColumn(int lane, int column) {
+    LaneGroup& group = groups[lane / groupSize];
+    int i = lane % groupSize;
+    int height = group.height[column][i];
+    if (height == 0) {
+        group.topRank[column][i] = emptyRank;
+        group.topColor[column][i] = anyColor;
+        group.topSuit[column][i] = noSuit;
+        return;
+    }
+
+    uint8_t top = cards[lane].columns[column][height - 1];
+    group.topRank[column][i] = rankOf(top);
+    group.topSuit[column][i] = suitOf(top);
+    group.topColor[column][i] = colorOf(suitOf(top));
+}
+
+void BatchRollout::refreshPile(int lane) {
+    LaneGroup& group = groups[lane / groupSize];
+    int i = lane % groupSize;
+    int count = group.pileCount[i];
+    uint8_t top = count > 0 ? cards[lane].pile[count - 1] : 0;
+    group.pileRank[i] = rankOf(top);
+    group.pileSuit[i] = suitOf(top);
+    group.pileColor[i] = colorOf(suitOf(top));
+}
+
+void BatchRollout::generate(int group, MoveSet* sets) const {
+    using namespace Simd;
+    using Simd::load;
+    const LaneGroup& g = groups[group];
+    for (int i = 0; i < groupSize; i++) sets[i] = MoveSet{ { 0, 0 } };
+
+    Bytes playing = load(g.playing);
+    if (laneMask(playing) == 0) return;
+
+    // every slot is tested for the 16 games at once, then its bit goes to each game where it holds
+    auto add = [&](int slot, Bytes legal) {
+        for (unsigned mask = laneMask(both(legal, playing)); mask != 0; mask &= mask - 1) {
+            sets[std::countr_zero(mask)].bits[slot >> 6] |= uint64_t(1) << (slot & 63);
+        }
+    };
+
+    const Bytes zero = splat(0), one = splat(1), all = splat(0xFF);
+
+    Bytes deckEmpty = equal(load(g.deckCount), zero);
+    Bytes pileEmpty = equal(load(g.pileCount), zero);
+    Bytes recycleAllowed = butNot(butNot(deckEmpty, pileEmpty), equal(load(g.recyclesLeft), zero));
+    add(drawSlot, either(butNot(all, deckEmpty), recycleAllowed));
+
+    // an empty reserve slot takes the Ace only, a filled one any higher rank
+    Bytes reserve[4], reserveLow[4], reserveHigh[4];
+    for (int slot = 0; slot < 4; slot++) {
+        reserve[slot] = load(g.reserveRank[slot]);
+        Bytes slotEmpty = equal(reserve[slot], zero);
+        reserveLow[slot] = plus(reserve[slot], one);
+        reserveHigh[slot] = either(both(slotEmpty, one), butNot(splat(13), slotEmpty));
+    }
+    auto fitsReserve = [&](Bytes rank, Bytes suit) {
+        Bytes fits = zero;
+        for (int slot = 0; slot < 4; slot++) {
+            fits = either(fits, both(equal(suit, splat(static_cast<uint8_t>(slot))), within(rank, reserveLow[slot], reserveHigh[slot])));
+        }
+        return fits;
+    };
+
+    Bytes tops[7], colors[7], runs[7], empties[7];
+    for (int column = 0; column < 7; column++) {
+        tops[column] = load(g.topRank[column]);
+        colors[column] = load(g.topColor[column]);
+        runs[column] = load(g.run[column]);
+        empties[column] = equal(load(g.height[column]), zero);
+    }
+
+    Bytes pileRank = load(g.pileRank);
+    Bytes pileNext = plus(pileRank, one);
+    Bytes pileColor = load(g.pileColor);
+    for (int to = 0; to < 7; to++) {
+        add(pileToColumnSlot + to, butNot(butNot(equal(tops[to], pileNext), equal(colors[to], pileColor)), pileEmpty));
+    }
+    add(pileToReserveSlot, butNot(fitsReserve(pileRank, load(g.pileSuit)), pileEmpty));
+
+    for (int from = 0; from < 7; from++) {
+        Bytes faceDownTop = equal(runs[from], zero);
+        add(columnToReserveSlot + from, butNot(fitsReserve(tops[from], load(g.topSuit[from])), faceDownTop));
+
+        // the run card fitting a column is count - 1 ranks above the top, with the top's color when count is odd
+        for (int to = 0; to < 7; to++) {
+            if (to == from) continue;
+            Bytes count = minus(tops[to], tops[from]);
+            Bytes inRun = butNot(equal(lower(count, runs[from]), count), equal(count, zero));
+            Bytes colorFits = either(empties[to], equal(differ(colors[from], colors[to]), both(count, one)));
+            add(columnToColumnSlot + from * 7 + to, both(inRun, colorFits));
+        }
+    }
+
+    for (int slot = 0; slot < 4; slot++) {
+        Bytes next = plus(reserve[slot], one);
+        Bytes slotColor = splat(colorOf(static_cast<uint8_t>(slot)));
+        Bytes slotEmpty = equal(reserve[slot], zero);
+        for (int to = 0; to < 7; to++) {
+            add(reserveToColumnSlot + slot * 7 + to, butNot(butNot(equal(tops[to], next), equal(colors[to], slotColor)), slotEmpty));
+        }
+    }
+}
+
+Move BatchRollout::slotMove(int lane, int slot) const {
+    const LaneGroup& group = groups[lane / groupSize];
+    int i = lane % groupSize;
+
+    if (slot == drawSlot) {
+        return { group.deckCount[i] > 0 ? MoveType::Draw : MoveType::Recycle, 0, 0, 0 };
+    }
+    if (slot < pileToReserveSlot) {
+        return { MoveType::PileToColumn, 0, static_cast<unsigned char>(slot - pileToColumnSlot), 1 };
+    }
+    if (slot == pileToReserveSlot) {
+        return { MoveType::PileToReserve, 0, suitOf(cards[lane].pile[group.pileCount[i] - 1]), 1 };
+    }
+    if (slot < columnToColumnSlot) {
+        int from = slot - columnToReserveSlot;
+        return { MoveType::ColumnToReserve, static_cast<unsigned char>(from), group.topSuit[from][i], 1 };
+    }
+    if (slot < reserveToColumnSlot) {
+        int from = (slot - columnToColumnSlot) / 7;
+        int to = (slot - columnToColumnSlot) % 7;
+        int count = group.topRank[to][i] - group.topRank[from][i];
+        return { MoveType::ColumnToColumn, static_cast<unsigned char>(from), static_cast<unsigned char>(to), static_cast<unsigned char>(count) };
+    }
+    int from = (slot - reserveToColumnSlot) / 7;
+    int to = (slot - reserveToColumnSlot) % 7;
+    return { MoveType::ReserveToColumn, static_cast<unsigned char>(from), static_cast<unsigned char>(to), 1 };
+}
+
+std::vector<Move> BatchRollout::getLegalMoves(int lane) const {
+    MoveSet sets[groupSize];
+    generate(lane / groupSize, sets);
+
+    std::vector<Move> moves;
+    const MoveSet& set = sets[lane % groupSize];
+    for (int word = 0; word < 2; word++) {
+        for (uint64_t bits = set.bits[word]; bits != 0; bits &= bits - 1) {
+            moves.push_back(slotMove(lane, word * 64 + std::countr_zero(bits)));
+        }
+    }
+    return moves;
+}
+
+int BatchRollout::choose(int lane, const MoveSet& set) {
+    int count = std::popcount(set.bits[0]) + std::popcount(set.bits[1]);
+
+    if (options.policy == RolloutPolicy::Random) {
+        int pick = static_cast<int>(nextRandom() % static_cast<uint64_t>(count));
+        for (int word = 0; word < 2; word++) {
+            int inWord = std::popcount(set.bits[word]);
+            if (pick >= inWord) {
+                pick -= inWord;
+                continue;
+            }
+            uint64_t bits = set.bits[word];
+            for (; pick > 0; pick--) bits &= bits - 1;
+            return word * 64 + std::countr_zero(bits);
+        }
+    }
+
+    // greedy: best score change, never undoing the previous move unless nothing else is legal
+    const LaneCards& lc = cards[lane];
+    int best = -1, bestScore = 0, ties = 0, undoSlot = -1;
+    for (int word = 0; word < 2; word++) {
+        for (uint64_t bits = set.bits[word]; bits != 0; bits &= bits - 1) {
+            int slot = word * 64 + std::countr_zero(bits);
+            Move move = slotMove(lane, slot);
+            if (lc.moves > 0 && SearchUtil::undoes(move, lc.lastMove)) {
+                undoSlot = slot;
+                continue;
+            }
+
+            int score = scoreChange(lane, move);
+            if (best < 0 || score > bestScore) {
+                best = slot;
+                bestScore = score;
+                ties = 1;
+            }
+            else if (score == bestScore && nextRandom() % static_cast<uint64_t>(++ties) == 0) {
+                best = slot;
+            }
+        }
+    }
+    return best >= 0 ? best : undoSlot;
+}
+
+int BatchRollout::scoreChange(int lane, const Move& move) const {
+    const LaneGroup& group = groups[lane / groupSize];
+    int i = lane % groupSize;
+    WeightedEvaluator::Features change{ 0, 0, 0, 0, 0, 0 };
+
+    auto kingRooted = [&](int column) {
+        int height = group.height[column][i];
+        return height > 0 && group.run[column][i] == height && group.topRank[column][i] + height - 1 == 13;
+    };
+    auto take = [&](int column, int count) {
+        int height = group.height[column][i];
+        if (kingRooted(column)) {
+            change.kingRunCards -= count;
+            if (height == 13) change.completeColumns--;
+        }
+        if (count == height) {
+            change.emptyColumns++;
+        }
+        else if (count == group.run[column][i]) {
+            change.faceDown--;
+            // a King turned up at the bottom starts a King run
+            if (height - count == 1 && rankOf(cards[lane].columns[column][0]) == 13) change.kingRunCards++;
+        }
+    };
+    auto put = [&](int column, int count, int startRank) {
+        bool empty = group.height[column][i] == 0;
+        if (empty) change.emptyColumns--;
+        if (empty ? startRank == 13 : kingRooted(column)) {
+            change.kingRunCards += count;
+            if (group.height[column][i] + count == 13) change.completeColumns++;
+        }
+    };
+
+    switch (move.type) {
+    case MoveType::PileToColumn:
+        put(move.to, 1, group.pileRank[i]);
+        change.stockCards--;
+        break;
+    case MoveType::PileToReserve:
+        change.reserveProgress += group.pileRank[i] - group.reserveRank[move.to][i];
+        change.stockCards--;
+        break;
+    case MoveType::ColumnToReserve:
+        change.reserveProgress += group.topRank[move.from][i] - group.reserveRank[move.to][i];
+        take(move.from, 1);
+        break;
+    case MoveType::ReserveToColumn:
+        put(move.to, 1, group.reserveRank[move.from][i]);
+        change.reserveProgress--;
+        break;
+    case MoveType::ColumnToColumn:
+        take(move.from, move.count);
+        put(move.to, move.count, group.topRank[move.from][i] + move.count - 1);
+        break;
+    default:
+        break;
+    }
+
+    const WeightedEvaluator::Weights& weights = options.weights;
+    return change.faceDown * weights.faceDown
+        + change.emptyColumns * weights.emptyColumns
+        + change.reserveProgress * weights.reserveProgress
+        + change.kingRunCards * weights.kingRunCards
+        + change.completeColumns * weights.completeColumns
+        + change.stockCards * weights.stockCards;
+}
+
+void BatchRollout::apply(int lane, const Move& move) {
+    LaneGroup& group = groups[lane / groupSize];
+    int i = lane % groupSize;
+    LaneCards& lc = cards[lane];
+
+    auto push = [&](int column, const uint8_t* moved, int count) {
+        std::memcpy(&lc.columns[column][group.height[column][i]], moved, count);
+        group.height[column][i] = static_cast<uint8_t>(group.height[column][i] + count);
+        group.run[column][i] = static_cast<uint8_t>(group.run[column][i] + count);
+        refreshColumn(lane, column);
+    };
+    auto pop = [&](int column, int count) {
+        group.height[column][i] = static_cast<uint8_t>(group.height[column][i] - count);
+        group.run[column][i] = static_cast<uint8_t>(group.run[column][i] - count);
+        int height = group.height[column][i];
+        if (height > 0 && group.run[column][i] == 0) {
+            lc.columns[column][height - 1] ^= faceUpBit;
+            group.run[column][i] = 1;
+        }
+        refreshColumn(lane, column);
+    };
+
+    switch (move.type) {
+    case MoveType::Draw:
+        lc.pile[group.pileCount[i]++] = lc.deck[--group.deckCount[i]] ^ faceUpBit;
+        refreshPile(lane);
+        break;
+    case MoveType::Recycle: {
+        // the same shuffle as Deck::reShuffle, so seeded games replay exactly like Game
+        int count = group.pileCount[i];
+        std::memcpy(lc.deck, lc.pile, count);
+        std::mt19937 generator;
+        if (lc.seeded) {
+            std::seed_seq sequence{ lc.seed, lc.shuffleCount };
+            generator.seed(sequence);
+        }
+        else {
+            std::random_device device;
+            generator.seed(device());
+        }
+        std::shuffle(lc.deck, lc.deck + count, generator);
+        lc.shuffleCount++;
+        for (int j = 0; j < count; j++) lc.deck[j] ^= faceUpBit;
+        group.deckCount[i] = static_cast<uint8_t>(count);
+        group.pileCount[i] = 0;
+        group.recyclesLeft[i]--;
+        refreshPile(lane);
+        break;
+    }
+    case MoveType::PileToColumn:
+        push(move.to, &lc.pile[--group.pileCount[i]], 1);
+        refreshPile(lane);
+        break;
+    case MoveType::PileToReserve:
+        group.reserveRank[move.to][i] = group.pileRank[i];
+        group.pileCount[i]--;
+        refreshPile(lane);
+        break;
+    case MoveType::ColumnToReserve:
+        group.reserveRank[move.to][i] = group.topRank[move.from][i];
+        pop(move.from, 1);
+        break;
+    case MoveType::ReserveToColumn: {
+        uint8_t rank = group.reserveRank[move.from][i];
+        uint8_t card = static_cast<uint8_t>(faceUpBit | (move.from * 13 + rank - 1));
+        push(move.to, &card, 1);
+        group.reserveRank[move.from][i] = static_cast<uint8_t>(rank - 1);
+        break;
+    }
+    case MoveType::ColumnToColumn: {
+        int start = group.height[move.from][i] - move.count;
+        push(move.to, &lc.columns[move.from][start], move.count);
+        pop(move.from, move.count);
+        break;
+    }
+    }
+
+    lc.lastMove = move;
+    lc.moves++;
+}
+
+void BatchRollout::markWins(int group) {
+    using namespace Simd;
+    using Simd::load;
+    LaneGroup& g = groups[group];
+
+    // a complete column is 13 face-up cards with an Ace on top, the run rule makes it King to Ace
+    Bytes complete = splat(0);
+    for (int column = 0; column < 7; column++) {
+        Bytes full = both(equal(load(g.run[column]), splat(13)), equal(load(g.height[column]), splat(13)));
+        complete = minus(complete, both(full, equal(load(g.topRank[column]), splat(1))));
+    }
+
+    for (unsigned mask = laneMask(both(equal(complete, splat(4)), load(g.playing))); mask != 0; mask &= mask - 1) {
+        int i = std::countr_zero(mask);
+        g.playing[i] = 0;
+        cards[group * groupSize + i].status = RolloutStatus::Won;
+    }
+}
+
+int BatchRollout::step() {
+    int stillPlaying = 0;
+
+    for (int group = 0; group < static_cast<int>(groups.size()); group++) {
+        LaneGroup& g = groups[group];
+        MoveSet* sets = &moveSets[static_cast<std::size_t>(group) * groupSize];
+        generate(group, sets);
+
+        for (unsigned mask = Simd::laneMask(Simd::load(g.playing)); mask != 0; mask &= mask - 1) {
+            int i = std::countr_zero(mask);
+            int lane = group * groupSize + i;
+            if ((sets[i].bits[0] | sets[i].bits[1]) == 0) {
+                g.playing[i] = 0;
+                cards[lane].status = RolloutStatus::Stuck;
+                continue;
+            }
+            apply(lane, slotMove(lane, choose(lane, sets[i])));
+        }
+        markWins(group);
+
+        for (unsigned mask = Simd::laneMask(Simd::load(g.playing)); mask != 0; mask &= mask - 1) {
+            int i = std::countr_zero(mask);
+            LaneCards& lc = cards[group * groupSize + i];
+            if (lc.moves >= options.maxSteps) {
+                g.playing[i] = 0;
+                lc.status = RolloutStatus::OutOfSteps;
+            }
+            else {
+                stillPlaying++;
+            }
+        }
+    }
+    return stillPlaying;
+}
+
+RolloutReport BatchRollout::run() {
+    RolloutReport report{ games, 0, 0, 0, 0, 0, 0.0, 0.0 };
+    auto start = std::chrono::steady_clock::now();
+
+    bool playing = false;
+    for (const LaneGroup& group : groups) {
+        if (Simd::laneMask(Simd::load(group.playing)) != 0) playing = true;
+    }
+    while (playing) {
+        playing = step() > 0;
+        report.steps++;
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (const LaneCards& lc : cards) {
+        report.moves += lc.moves;
+        switch (lc.status) {
+        case RolloutStatus::Won:        report.won++; break;
+        case RolloutStatus::OutOfSteps: report.outOfSteps++; break;
+        default:                        report.stuck++; break;
+        }
+    }
+    report.movesPerSecond = report.seconds > 0.0 ? report.moves / report.seconds : 0.0;
+    return report;
+}
+
+std::string BatchRollout::packState(int lane) const {
+    const LaneGroup& group = groups[lane / groupSize];
+    int i = lane % groupSize;
+    const LaneCards& lc = cards[lane];
+
+    std::string out;
+    out.push_back(static_cast<char>(group.deckCount[i]));
+    out.append(reinterpret_cast<const char*>(lc.deck), group.deckCount[i]);
+    out.push_back(static_cast<char>(group.pileCount[i]));
+    out.append(reinterpret_cast<const char*>(lc.pile), group.pileCount[i]);
+    for (int column = 0; column < Game::columnsSize; column++) {
+        out.push_back(static_cast<char>(group.height[column][i]));
+        out.append(reinterpret_cast<const char*>(lc.columns[column]), group.height[column][i]);
+    }
+    for (int slot = 0; slot < Game::reserveSlotSize; slot++) {
+        uint8_t rank = group.reserveRank[slot][i];
+        out.push_back(static_cast<char>(rank == 0 ? 0xFF : faceUpBit | (slot * 13 + rank - 1)));
+    }
+    return out;
+}
+
+uint64_t BatchRollout::nextRandom() {
+    // splitmix64, any seed gives a full-period sequence
+    uint64_t z = (randomState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
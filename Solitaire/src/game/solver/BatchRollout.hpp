@@ -0,0 +1,267 @@
+#pragma once
+#include "Evaluator.hpp"
+#include "../util/simd.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file BatchRollout.hpp
+ * @brief Declares BatchRollout, an engine playing many games side by side one move per step.
+ */
+
+/**
+ * @enum RolloutPolicy
+ * @brief How every game of a batch picks its move.
+ */
+enum class RolloutPolicy : unsigned char {
+    Random,  ///< Any legal move, with equal chances.
+    Greedy   ///< The move raising the WeightedEvaluator score most, ties at random, not undoing the previous move if avoidable.
+};
+
+/**
+ * @enum RolloutStatus
+ * @brief State of one game of a batch.
+ */
+enum class RolloutStatus : unsigned char {
+    Playing,    ///< Still moving.
+    Won,        ///< Game::isGameWon holds.
+    Stuck,      ///< No legal move is left, recycles included.
+    OutOfSteps  ///< RolloutOptions::maxSteps moves were played without a result.
+};
+
+/**
+ * @struct RolloutOptions
+ * @brief Limits and policy of a batch.
+ */
+struct RolloutOptions {
+    RolloutPolicy policy = RolloutPolicy::Random;  ///< Move choice of every game.
+    int maxSteps = 400;                            ///< Moves per game before it stops.
+    int maxRecycles = 2;                           ///< Pile recycles allowed per game.
+    uint64_t randomSeed = 1;                       ///< Seed of the move choices.
+    WeightedEvaluator::Weights weights;            ///< Weights of the Greedy policy.
+};
+
+/**
+ * @struct RolloutReport
+ * @brief Outcome and speed of a batch.
+ */
+struct RolloutReport {
+    int games;              ///< Games in the batch.
+    int won;                ///< Games won.
+    int stuck;              ///< Games left without a legal move.
+    int outOfSteps;         ///< Games stopped by the step limit.
+    int steps;              ///< Steps until every game stopped.
+    uint64_t moves;         ///< Moves played over all games.
+    double seconds;         ///< Wall-clock time of the steps.
+    double movesPerSecond;  ///< Moves per second over all games.
+};
+
+/**
+ * @class BatchRollout
+ * @brief Holds a batch of games in groups of 16 lanes and advances all of them one move per step.
+ *
+ * Everything a move check reads is kept as rows with one byte per game: rank, color, suit,
+ * face-up run and height of every column top, the reserve ranks and the top of the pile and the
+ * deck sizes. A step tests every possible move of 16 games at once with the Simd row operations,
+ * for example the pile card of all 16 games against column 3 of all 16 games, and collects the
+ * legal moves of every game as bits. Each game then applies its chosen move to its own cards
+ * one game at a time, as the moves of different games touch different bytes.
+ *
+ * Face-up column cards always form alternating runs down from the top card, as in every game
+ * dealt by Game, so a run needs no more than its top and length: column-to-column moves come
+ * from one subtraction of two top ranks. Games follow the rules of Game exactly, including the
+ * seeded reshuffles of recycled piles, and packState gives the same bytes as Game::packState.
+ *
+ * Not thread safe; a batch per thread scales across cores.
+ */
+class BatchRollout {
+public:
+    static const int groupSize = Simd::lanes;  ///< Games in one group of rows.
+    static const int maxColumnCards = 19;      ///< Most cards of a column: six face-down cards under a King to Ace run.
+
+    /**
+     * @brief Creates a batch of empty games, which stay out of play until they are dealt or loaded.
+     * @param games Number of games.
+     * @param options Limits and policy.
+     */
+    BatchRollout(int games, const RolloutOptions& options = RolloutOptions());
+
+    /**
+     * @brief Deals a seeded game into a lane, the same deal as Game::reset(seed).
+     * @param lane Game index.
+     * @param seed Seed of the deal.
+     */
+    void deal(int lane, unsigned int seed);
+
+    /**
+     * @brief Copies a position into a lane.
+     * @param lane Game index.
+     * @param game Position to copy, reached by play from a deal.
+     * @return False if face-up cards do not form alternating runs or a column is too high, the lane is then out of play.
+     */
+    bool load(int lane, const Game& game);
+
+    /**
+     * @brief Plays one move in every game still playing.
+     * @return Number of games still playing.
+     */
+    int step();
+
+    /**
+     * @brief Steps until every game stops.
+     * @return Outcome and speed of the batch.
+     */
+    RolloutReport run();
+
+    /**
+     * @brief Lists the legal moves of a game.
+     * @param lane Game index.
+     * @return The moves of SearchUtil::searchMoves, grouped by kind, empty once the game stopped.
+     */
+    std::vector<Move> getLegalMoves(int lane) const;
+
+    /**
+     * @brief Packs the position of a game.
+     * @param lane Game index.
+     * @return Bytes of Game::packState, accepted by Game::unpackState.
+     */
+    std::string packState(int lane) const;
+
+    /**
+     * @brief Gets the state of a game.
+     * @param lane Game index.
+     * @return Status of the lane.
+     */
+    RolloutStatus getStatus(int lane) const { return cards[lane].status; }
+
+    /**
+     * @brief Gets the last move of a game.
+     * @param lane Game index.
+     * @return Move of the last step the game played in.
+     */
+    const Move& getLastMove(int lane) const { return cards[lane].lastMove; }
+
+    /**
+     * @brief Gets the number of moves a game played.
+     * @param lane Game index.
+     * @return Moves since the game was dealt or loaded.
+     */
+    int getMoveCount(int lane) const { return cards[lane].moves; }
+
+    /**
+     * @brief Gets the number of games.
+     * @return Games in the batch.
+     */
+    int getGameCount() const { return games; }
+
+private:
+    /// Legal moves of one game, one bit per move slot.
+    struct MoveSet {
+        uint64_t bits[2];  ///< Slots 0-63 and 64-127.
+    };
+
+    /**
+     * @brief Rows of 16 games, everything move generation reads.
+     */
+    struct alignas(16) LaneGroup {
+        uint8_t topRank[7][groupSize];      ///< Rank of the top card, 14 for an empty column.
+        uint8_t topColor[7][groupSize];     ///< 1 for a red top, 0 for black, 2 for an empty column.
+        uint8_t topSuit[7][groupSize];      ///< Suit of the top card, 4 for an empty column.
+        uint8_t run[7][groupSize];          ///< Face-up cards on top.
+        uint8_t height[7][groupSize];       ///< Cards in the column.
+        uint8_t reserveRank[4][groupSize];  ///< Rank in every reserve slot, 0 for an empty slot.
+        uint8_t pileRank[groupSize];        ///< Rank of the top pile card.
+        uint8_t pileColor[groupSize];       ///< Color of the top pile card.
+        uint8_t pileSuit[groupSize];        ///< Suit of the top pile card.
+        uint8_t pileCount[groupSize];       ///< Cards in the pile.
+        uint8_t deckCount[groupSize];       ///< Cards in the deck.
+        uint8_t recyclesLeft[groupSize];    ///< Recycles the game may still use.
+        uint8_t playing[groupSize];         ///< 0xFF while the game is playing, 0 otherwise.
+    };
+
+    /**
+     * @brief Cards of one game, read only by the game's own moves.
+     */
+    struct LaneCards {
+        uint8_t columns[7][maxColumnCards];  ///< Column cards from the bottom, as Card::pack bytes.
+        uint8_t deck[52];                    ///< Deck cards, the top last.
+        uint8_t pile[52];                    ///< Pile cards, the top last.
+        bool seeded = false;                 ///< Whether recycles replay the seeded shuffles of Deck.
+        unsigned int seed = 0;               ///< Seed of the deal.
+        unsigned int shuffleCount = 0;       ///< Shuffles done, as Deck::getShuffleCount.
+        Move lastMove{};                     ///< Last move played.
+        int moves = 0;                       ///< Moves played.
+        RolloutStatus status = RolloutStatus::Stuck; ///< State of the game, lanes out of play count as stuck.
+    };
+
+    /**
+     * @brief Tests every move slot of a group of games.
+     * @param group Group index.
+     * @param sets Receives the legal moves of the 16 games.
+     */
+    void generate(int group, MoveSet* sets) const;
+
+    /**
+     * @brief Turns a move slot of a game into a move.
+     * @param lane Game index.
+     * @param slot Move slot.
+     * @return Move of the slot.
+     */
+    Move slotMove(int lane, int slot) const;
+
+    /**
+     * @brief Chooses the move of a game by the policy.
+     * @param lane Game index.
+     * @param set Legal moves of the game, not empty.
+     * @return Chosen move slot.
+     */
+    int choose(int lane, const MoveSet& set);
+
+    /**
+     * @brief Computes how much a move changes the WeightedEvaluator score.
+     * @param lane Game index.
+     * @param move Legal move.
+     * @return Score after the move minus score before it.
+     */
+    int scoreChange(int lane, const Move& move) const;
+
+    /**
+     * @brief Plays a legal move.
+     * @param lane Game index.
+     * @param move Move to play.
+     */
+    void apply(int lane, const Move& move);
+
+    /**
+     * @brief Updates the top rows of a column from its cards.
+     * @param lane Game index.
+     * @param column Column index.
+     */
+    void refreshColumn(int lane, int column);
+
+    /**
+     * @brief Updates the pile rows from the pile cards.
+     * @param lane Game index.
+     */
+    void refreshPile(int lane);
+
+    /**
+     * @brief Marks the games of a group that are won.
+     * @param group Group index.
+     */
+    void markWins(int group);
+
+    /**
+     * @brief Draws the next number of the move choices.
+     * @return Random 64-bit number.
+     */
+    uint64_t nextRandom();
+
+    RolloutOptions options;         ///< Limits and policy.
+    int games;                      ///< Games in the batch.
+    std::vector<LaneGroup> groups;  ///< Rows of every group of 16 games.
+    std::vector<LaneCards> cards;   ///< Cards of every game.
+    std::vector<MoveSet> moveSets;  ///< Legal moves of every game, rebuilt every step.
+    uint64_t randomState;           ///< State of the move choice generator.
+};
@@ -0,0 +1,96 @@
+#include "Certificate.hpp"
+
+/// Hex digits used by the encoding.
+static const char hexDigits[] = "0123456789abcdef";
+
+/// @brief Converts a hex digit to its value.
+/// @return Value of the digit, -1 if the character is not a hex digit.
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/// @brief Plays one move through the public move methods only.
+static bool replayMove(Game& game, const Move& move) {
+    switch (move.type) {
+    case MoveType::Draw:            return game.drawCard();
+    case MoveType::ColumnToColumn:  return game.moveCard(move.from, move.to, move.count);
+    case MoveType::PileToColumn:    return game.moveFromPileToColumn(move.to);
+    case MoveType::PileToReserve:   return game.moveFromPileToReserve(move.to);
+    case MoveType::ColumnToReserve: return game.moveFromColumnToReserve(move.from, move.to);
+    case MoveType::ReserveToColumn: return game.moveFromReserveToColumn(move.from, move.to);
+    case MoveType::Recycle:         return game.recycleStock();
+    }
+    return false;
+}
+
+/// @brief Checks the win condition on its own: four columns of King to Ace in alternating colours, all face up.
+static bool isWon(const Game& game) {
+    int completeColumns = 0;
+    for (int i = 0; i < Game::columnsSize; i++) {
+        const std::vector<Card>& column = game.getColumn(i);
+        if (column.size() != 13) continue;
+
+        bool complete = true;
+        for (int j = 0; j < 13 && complete; j++) {
+            complete = column[j].isValid() && column[j].isFacingUp()
+                && static_cast<int>(column[j].getRank()) == 13 - j
+                && (j == 0 || column[j].isRed() != column[j - 1].isRed());
+        }
+        if (complete) completeColumns++;
+    }
+    return completeColumns == 4;
+}
+
+std::string Certificate::encode(const std::vector<Move>& moves) {
+    std::string text;
+    text.reserve(moves.size() * 4);
+    for (const Move& move : moves) {
+        unsigned char first = static_cast<unsigned char>((static_cast<int>(move.type) << 4) | (move.from & 0x0F));
+        unsigned char second = static_cast<unsigned char>((move.to << 4) | (move.count & 0x0F));
+        text.push_back(hexDigits[first >> 4]);
+        text.push_back(hexDigits[first & 0x0F]);
+        text.push_back(hexDigits[second >> 4]);
+        text.push_back(hexDigits[second & 0x0F]);
+    }
+    return text;
+}
+
+bool Certificate::decode(const std::string& text, std::vector<Move>& moves) {
+    moves.clear();
+    if (text.size() % 4 != 0) return false;
+    moves.reserve(text.size() / 4);
+
+    for (std::size_t i = 0; i < text.size(); i += 4) {
+        int digits[4];
+        for (int j = 0; j < 4; j++) {
+            digits[j] = hexValue(text[i + j]);
+            if (digits[j] < 0) return false;
+        }
+        if (digits[0] > static_cast<int>(MoveType::Recycle)) return false;
+
+        moves.push_back({ static_cast<MoveType>(digits[0]),
+            static_cast<unsigned char>(digits[1]),
+            static_cast<unsigned char>(digits[2]),
+            static_cast<unsigned char>(digits[3]) });
+    }
+    return true;
+}
+
+bool Certificate::verify(unsigned int seed, const std::vector<Move>& moves) {
+    Game game;
+    game.reset(seed);
+
+    for (const Move& move : moves) {
+        // indices are checked here, the move methods only assert them
+        if (move.from >= Game::columnsSize || move.to >= Game::columnsSize) return false;
+        bool reserveSource = move.type == MoveType::ReserveToColumn;
+        bool reserveTarget = move.type == MoveType::PileToReserve || move.type == MoveType::ColumnToReserve;
+        if ((reserveSource && move.from >= Game::reserveSlotSize) || (reserveTarget && move.to >= Game::reserveSlotSize)) return false;
+
+        if (!replayMove(game, move)) return false;
+    }
+    return isWon(game);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "../Game.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @file Certificate.hpp
+ * @brief Declares solution certificates: compact winning move lists and their independent verifier.
+ */
+
+/**
+ * @namespace Certificate
+ * @brief Encodes winning lines and checks them against a fresh deal.
+ *
+ * A move takes two bytes written as four hex digits: type and source in the first byte,
+ * destination and card count in the second. The verifier only uses the public move methods
+ * of Game and its own win check, sharing no code with the solvers, so a solver bug cannot make
+ * a wrong certificate pass.
+ */
+namespace Certificate {
+    /**
+     * @brief Encodes a move list as hex text.
+     * @param moves Moves to encode.
+     * @return Four hex digits per move.
+     */
+    std::string encode(const std::vector<Move>& moves);
+
+    /**
+     * @brief Decodes hex text created by encode.
+     * @param text Encoded moves.
+     * @param moves Decoded moves.
+     * @return False if the text is malformed.
+     */
+    bool decode(const std::string& text, std::vector<Move>& moves);
+
+    /**
+     * @brief Replays moves on a fresh game dealt from a seed and checks that they win it.
+     * @param seed Seed of the deal.
+     * @param moves Winning line to check.
+     * @return True if every move is legal and the final position is won.
+     */
+    bool verify(unsigned int seed, const std::vector<Move>& moves);
+}
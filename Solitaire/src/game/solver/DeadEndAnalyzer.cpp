@@ -0,0 +1,53 @@
+#include "DeadEndAnalyzer.hpp"
+#include "../Tableau.hpp"
+
+/// @brief Checks if a card fits on any column or on its reserve slot.
+static bool cardCanPlay(const Game& game, const Tableau& tableau, const Card& card) {
+    if (game.canPlaceOnReserve(card, static_cast<int>(card.getSuit()))) return true;
+    return tableau.acceptMask(card) != 0;
+}
+
+bool DeadEndAnalyzer::hasBoardMove(const Game& game) {
+    Tableau tableau(game);
+    if (tableau.foundationMask() != 0) return true;
+
+    for (int from = 0; from < Game::columnsSize; from++) {
+        int runLength = tableau.getRunLength(from);
+        for (int depth = 0; depth < runLength; depth++) {
+            // a King run already at the bottom would only move to another empty column
+            if (depth + 1 == tableau.getHeight(from) && tableau.getRank(from, depth) == static_cast<int>(Rank::King)) break;
+            if (tableau.acceptMask(from, depth) != 0) return true;
+        }
+    }
+
+    for (int slot = 0; slot < Game::reserveSlotSize; slot++) {
+        const Card& card = game.getReserveSlot(slot);
+        if (card.isValid() && tableau.acceptMask(card) != 0) return true;
+    }
+    return false;
+}
+
+bool DeadEndAnalyzer::stockCanPlay(const Game& game) {
+    Tableau tableau(game);
+    for (const Card& card : game.getDeck().getCards()) {
+        if (cardCanPlay(game, tableau, card)) return true;
+    }
+    for (const Card& card : game.getPile()) {
+        if (cardCanPlay(game, tableau, card)) return true;
+    }
+    return false;
+}
+
+bool DeadEndAnalyzer::isDeadEnd(const Game& game) {
+    // drawing and recycling leave columns and reserve untouched, so if nothing can reach them
+    // now, nothing ever will
+    return !hasBoardMove(game) && !stockCanPlay(game) && !game.isGameWon();
+}
+
+DeadEndAnalyzer::Report DeadEndAnalyzer::analyze(const Game& game) {
+    if (isDeadEnd(game)) return { Verdict::DeadEnd, Move{} };
+
+    std::vector<Move> moves = game.getLegalMoves(true);
+    if (moves.size() == 1) return { Verdict::Forced, moves[0] };
+    return { Verdict::Open, Move{} };
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "../Game.hpp"
+
+/**
+ * @file DeadEndAnalyzer.hpp
+ * @brief Declares static checks that recognise lost positions and forced moves without searching.
+ */
+
+/**
+ * @namespace DeadEndAnalyzer
+ * @brief Fast rules over a single position, cheap enough to run at every search node.
+ *
+ * Only rules that are proven for this variant are used. Reserve slots hand cards back and
+ * produce lower ranks of their suit, so a card buried under a card it needs is not lost by
+ * itself; the rule that holds is that of a frozen board: when no column or reserve move exists
+ * and no card of the stock fits anywhere, drawing and recycling can never change the tableau.
+ */
+namespace DeadEndAnalyzer {
+    /**
+     * @enum Verdict
+     * @brief Classification of a position.
+     */
+    enum class Verdict : unsigned char {
+        Open,     ///< Several moves remain, search is needed.
+        Forced,   ///< Exactly one legal move remains.
+        DeadEnd   ///< The game can no longer be won.
+    };
+
+    /**
+     * @struct Report
+     * @brief Verdict with the forced move when there is one.
+     */
+    struct Report {
+        Verdict verdict;   ///< Classification of the position.
+        Move forcedMove;   ///< The only legal move, meaningful for Forced only.
+    };
+
+    /**
+     * @brief Checks if any card can move between columns and reserve slots.
+     * @param game Position to check.
+     * @return True if a column-to-column, column-to-reserve or reserve-to-column move is legal.
+     */
+    bool hasBoardMove(const Game& game);
+
+    /**
+     * @brief Checks if any card of the deck or pile fits on a column or reserve slot.
+     * @param game Position to check.
+     * @return True if at least one stock card could be played once it is on top of the pile.
+     */
+    bool stockCanPlay(const Game& game);
+
+    /**
+     * @brief Checks if the position is proven lost.
+     * @param game Position to check.
+     * @return True if the game is not won and the board can never change again.
+     */
+    bool isDeadEnd(const Game& game);
+
+    /**
+     * @brief Classifies a position as a dead end, a forced move or open.
+     * @param game Position to analyze.
+     * @return Verdict and forced move.
+     */
+    Report analyze(const Game& game);
+}
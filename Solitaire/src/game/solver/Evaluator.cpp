@@ -0,0 +1,80 @@
+#include "Evaluator.hpp"
+#include <sstream>
+
+int& WeightedEvaluator::Weights::operator[](int index) {
+    ASSERT(index >= 0 && index < count);
+    int* values[count] = { &faceDown, &emptyColumns, &reserveProgress, &kingRunCards, &completeColumns, &stockCards };
+    return *values[index];
+}
+
+std::string WeightedEvaluator::Weights::toString() const {
+    std::ostringstream out;
+    out << faceDown << "," << emptyColumns << "," << reserveProgress << ","
+        << kingRunCards << "," << completeColumns << "," << stockCards;
+    return out.str();
+}
+
+bool WeightedEvaluator::Weights::parse(const std::string& text, Weights& weights) {
+    std::istringstream in(text);
+    Weights parsed;
+    for (int i = 0; i < count; i++) {
+        std::string value;
+        if (!std::getline(in, value, ',')) return false;
+        try {
+            std::size_t used = 0;
+            parsed[i] = std::stoi(value, &used);
+            if (used != value.size()) return false;
+        }
+        catch (...) {
+            return false;
+        }
+    }
+    std::string rest;
+    if (std::getline(in, rest)) return false;
+
+    weights = parsed;
+    return true;
+}
+
+WeightedEvaluator::Features WeightedEvaluator::extract(const Game& game) {
+    Features features{ 0, 0, 0, 0, 0, 0 };
+
+    for (int i = 0; i < Game::columnsSize; i++) {
+        const std::vector<Card>& column = game.getColumn(i);
+        if (column.empty()) {
+            features.emptyColumns++;
+            continue;
+        }
+        for (const Card& card : column) {
+            if (!card.isFacingUp()) features.faceDown++;
+        }
+
+        if (!column[0].isFacingUp() || column[0].getRank() != Rank::King) continue;
+        int run = 1;
+        while (run < static_cast<int>(column.size())
+            && column[run].isFacingUp()
+            && column[run].isRed() != column[run - 1].isRed()
+            && static_cast<int>(column[run].getRank()) + 1 == static_cast<int>(column[run - 1].getRank())) {
+            run++;
+        }
+        features.kingRunCards += run;
+        if (run == 13) features.completeColumns++;
+    }
+
+    for (int slot = 0; slot < Game::reserveSlotSize; slot++) {
+        const Card& card = game.getReserveSlot(slot);
+        if (card.isValid()) features.reserveProgress += static_cast<int>(card.getRank());
+    }
+    features.stockCards = static_cast<int>(game.getDeck().getCards().size() + game.getPile().size());
+    return features;
+}
+
+int WeightedEvaluator::evaluate(const Game& game) const {
+    Features features = extract(game);
+    return features.faceDown * weights.faceDown
+        + features.emptyColumns * weights.emptyColumns
+        + features.reserveProgress * weights.reserveProgress
+        + features.kingRunCards * weights.kingRunCards
+        + features.completeColumns * weights.completeColumns
+        + features.stockCards * weights.stockCards;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "../Game.hpp"
+#include <string>
+
+/**
+ * @file Evaluator.hpp
+ * @brief Declares the position evaluation interface and its default weighted-feature implementation.
+ */
+
+/**
+ * @class Evaluator
+ * @brief Scores positions for guided search and bots, higher is closer to a win.
+ *
+ * Implementations must not keep state changed by evaluate, so one instance can be shared by
+ * solvers running on several threads.
+ */
+class Evaluator {
+public:
+    virtual ~Evaluator() = default;
+
+    /**
+     * @brief Scores a position.
+     * @param game Position to score.
+     * @return Score, only differences between positions matter.
+     */
+    virtual int evaluate(const Game& game) const = 0;
+};
+
+/**
+ * @class WeightedEvaluator
+ * @brief Default evaluator: a weighted sum of features counted towards the Game::isGameWon condition.
+ */
+class WeightedEvaluator : public Evaluator {
+public:
+    /**
+     * @brief Features of a position.
+     */
+    struct Features {
+        int faceDown;         ///< Face-down cards in columns.
+        int emptyColumns;     ///< Empty columns.
+        int reserveProgress;  ///< Sum of the ranks of reserve slot cards.
+        int kingRunCards;     ///< Cards in alternating runs built down from a King at a column bottom.
+        int completeColumns;  ///< Columns holding a full King to Ace run.
+        int stockCards;       ///< Cards left in the deck and pile.
+    };
+
+    /**
+     * @brief Weight of every feature.
+     */
+    struct Weights {
+        int faceDown = -6;         ///< Weight of Features::faceDown.
+        int emptyColumns = 2;      ///< Weight of Features::emptyColumns.
+        int reserveProgress = 0;   ///< Weight of Features::reserveProgress.
+        int kingRunCards = 4;      ///< Weight of Features::kingRunCards.
+        int completeColumns = 10;  ///< Weight of Features::completeColumns.
+        int stockCards = -1;       ///< Weight of Features::stockCards.
+
+        /// Number of weights.
+        static const int count = 6;
+
+        /**
+         * @brief Accesses a weight by index, in declaration order.
+         * @param index Weight index [0, count).
+         * @return Reference to the weight.
+         */
+        int& operator[](int index);
+
+        /**
+         * @brief Formats the weights as comma-separated values.
+         * @return Text accepted by parse.
+         */
+        std::string toString() const;
+
+        /**
+         * @brief Parses comma-separated weights in declaration order.
+         * @param text Text created by toString.
+         * @param weights Parsed weights.
+         * @return False if the text does not hold exactly count integers.
+         */
+        static bool parse(const std::string& text, Weights& weights);
+    };
+
+    /**
+     * @brief Creates an evaluator with the default weights.
+     */
+    WeightedEvaluator() = default;
+
+    /**
+     * @brief Creates an evaluator.
+     * @param weights Feature weights.
+     */
+    explicit WeightedEvaluator(const Weights& weights) : weights(weights) {}
+
+    int evaluate(const Game& game) const override;
+
+    /**
+     * @brief Counts the features of a position.
+     * @param game Position to inspect.
+     * @return Feature values.
+     */
+    static Features extract(const Game& game);
+
+    /**
+     * @brief Gets the weights.
+     * @return Feature weights.
+     */
+    const Weights& getWeights() const { return weights; }
+
+private:
+    Weights weights; ///< Feature weights.
+};
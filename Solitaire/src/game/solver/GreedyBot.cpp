@@ -0,0 +1,47 @@
+#include "GreedyBot.hpp"
+#include "DeadEndAnalyzer.hpp"
+#include "SearchUtil.hpp"
+
+GreedyBot::GreedyBot(const Evaluator& evaluator, int maxRecycles) : evaluator(&evaluator), maxRecycles(maxRecycles) {}
+
+void GreedyBot::reset(const Game& game) {
+    seen.clear();
+    seen.insert(SearchUtil::stateKey(game));
+}
+
+bool GreedyBot::choose(const Game& game, Move& move) {
+    uint64_t bestKey = 0;
+    int bestScore = 0;
+    bool found = false;
+
+    for (const Move& candidate : SearchUtil::searchMoves(game, maxRecycles)) {
+        Game child = game;
+        child.applyMove(candidate);
+        if (child.isGameWon()) {
+            move = candidate;
+            return true;
+        }
+
+        uint64_t key = SearchUtil::stateKey(child);
+        if (seen.count(key) != 0 || DeadEndAnalyzer::isDeadEnd(child)) continue;
+
+        int score = evaluator->evaluate(child);
+        if (!found || score > bestScore) {
+            move = candidate;
+            bestKey = key;
+            bestScore = score;
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    seen.insert(bestKey);
+    return true;
+}
+
+bool GreedyBot::step(Game& game) {
+    Move move{};
+    if (!choose(game, move)) return false;
+    game.applyMove(move);
+    return true;
+}
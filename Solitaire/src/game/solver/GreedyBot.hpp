@@ -0,0 +1,52 @@
+#pragma once
+#include "Evaluator.hpp"
+#include <cstdint>
+#include <unordered_set>
+
+/**
+ * @file GreedyBot.hpp
+ * @brief Declares GreedyBot, a player that makes one evaluator-guided move at a time.
+ */
+
+/**
+ * @class GreedyBot
+ * @brief Plays the move leading to the best scored position it has not visited yet.
+ *
+ * Remembering visited positions keeps the bot from looping between two moves; positions
+ * recognised by DeadEndAnalyzer are never entered. Used by self-play tuning and the dashboard.
+ */
+class GreedyBot {
+public:
+    /**
+     * @brief Creates a bot.
+     * @param evaluator Evaluator guiding the bot, must outlive it.
+     * @param maxRecycles Pile recycles the bot may use.
+     */
+    GreedyBot(const Evaluator& evaluator, int maxRecycles);
+
+    /**
+     * @brief Forgets visited positions and starts from a new game.
+     * @param game Starting position.
+     */
+    void reset(const Game& game);
+
+    /**
+     * @brief Chooses the next move and remembers the position it leads to as visited.
+     * @param game Position the bot was reset with or moved to last.
+     * @param move Receives the move, which the caller is expected to apply to game.
+     * @return False if no unvisited position can be reached.
+     */
+    bool choose(const Game& game, Move& move);
+
+    /**
+     * @brief Plays one move with Game::applyMove, so subscribers of the game see the move itself.
+     * @param game Game to move in, the position the bot was reset with or moved to last.
+     * @return False if no unvisited position can be reached, the game is then unchanged.
+     */
+    bool step(Game& game);
+
+private:
+    const Evaluator* evaluator;      ///< Evaluator guiding the bot.
+    int maxRecycles;                 ///< Recycle limit.
+    std::unordered_set<uint64_t> seen; ///< Keys of visited positions.
+};
@@ -0,0 +1,48 @@
+#include "PortfolioSolver.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+PortfolioSolver::PortfolioSolver(const SolverOptions& options, const std::vector<SolverMode>& modes)
+    : options(options), modes(modes) {
+}
+
+SolveResult PortfolioSolver::solve(const Game& root) {
+    solution.clear();
+    nodes = 0;
+    stats = SolverStats();
+
+    std::atomic<bool> stop(false);
+    std::mutex resultMutex;
+    SolveResult result = SolveResult::Unknown;
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < modes.size(); i++) {
+        SolverMode mode = modes[i];
+        threads.emplace_back([&, mode, i]() {
+            SolverOptions modeOptions = options;
+            modeOptions.mode = mode;
+            Solver solver(modeOptions);
+            solver.setStopFlag(&stop);
+
+            Game game = root;
+            SolveResult modeResult = solver.solve(game);
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            nodes += solver.getNodeCount();
+            if (i == 0 && result == SolveResult::Unknown) stats = solver.getStats();
+            if (modeResult != SolveResult::Unknown && result == SolveResult::Unknown) {
+                result = modeResult;
+                solution = solver.getSolution();
+                stats = solver.getStats();
+                winningMode = mode;
+                stop.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return result;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "Solver.hpp"
+#include <vector>
+
+/**
+ * @file PortfolioSolver.hpp
+ * @brief Declares the PortfolioSolver class which races several solver modes on the same deal.
+ */
+
+/**
+ * @class PortfolioSolver
+ * @brief Runs one Solver per mode on separate threads and keeps the first definitive answer.
+ *
+ * Each mode gets its own copy of the position and its own tables. As soon as one of them
+ * returns Won or Lost, a shared stop flag cancels the others, so the time spent on a deal is
+ * that of the fastest mode for it.
+ */
+class PortfolioSolver {
+public:
+    /**
+     * @brief Creates a portfolio.
+     * @param options Limits shared by all modes, the mode field is ignored.
+     * @param modes Modes raced against each other.
+     */
+    PortfolioSolver(const SolverOptions& options,
+        const std::vector<SolverMode>& modes = { SolverMode::DepthFirst, SolverMode::BestFirst, SolverMode::ProofNumber });
+
+    /**
+     * @brief Solves a position with all modes in parallel.
+     * @param root Position to solve.
+     * @return First definitive result, Unknown if every mode gave up.
+     */
+    SolveResult solve(const Game& root);
+
+    /**
+     * @brief Gets the winning move sequence of the last Won result.
+     * @return Moves from the root to the win.
+     */
+    const std::vector<Move>& getSolution() const { return solution; }
+
+    /**
+     * @brief Gets the positions expanded by all modes together in the last search.
+     * @return Node count.
+     */
+    uint64_t getNodeCount() const { return nodes; }
+
+    /**
+     * @brief Gets the mode that produced the last definitive result.
+     * @return Winning mode, meaningless when the result was Unknown.
+     */
+    SolverMode getWinningMode() const { return winningMode; }
+
+    /**
+     * @brief Gets the telemetry of the mode that produced the last result.
+     * @return Statistics of the winning mode, or of the first mode when every mode gave up.
+     */
+    const SolverStats& getStats() const { return stats; }
+
+private:
+    SolverOptions options;          ///< Limits shared by all modes.
+    std::vector<SolverMode> modes;  ///< Raced modes.
+    std::vector<Move> solution;     ///< Winning line of the last search.
+    uint64_t nodes = 0;             ///< Nodes expanded by all modes.
+    SolverStats stats;              ///< Telemetry of the winning mode.
+    SolverMode winningMode = SolverMode::DepthFirst; ///< Mode of the last definitive result.
+};
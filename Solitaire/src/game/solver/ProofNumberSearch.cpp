@@ -0,0 +1,309 @@
+#include "ProofNumberSearch.hpp"
+#include "DeadEndAnalyzer.hpp"
+#include <algorithm>
+#include <cstring>
+
+/// Proof and disproof number treated as infinity.
+static const uint32_t infinity = 100000000;
+
+/// @brief Adds proof numbers, saturating at infinity.
+static uint32_t addCapped(uint32_t a, uint32_t b) {
+    uint64_t sum = static_cast<uint64_t>(a) + b;
+    return sum >= infinity ? infinity : static_cast<uint32_t>(sum);
+}
+
+ProofNumberTable::ProofNumberTable(std::size_t memoryBytes) {
+    std::size_t buckets = 1;
+    while ((buckets * 2) * bucketSize * sizeof(Entry) <= memoryBytes) {
+        buckets *= 2;
+    }
+    memory.assign(buckets * bucketSize, Entry{ 0, 0, 0, 0, 0 });
+    entries = memory.data();
+    entryCount = memory.size();
+    bucketMask = buckets - 1;
+}
+
+ProofNumberTable::~ProofNumberTable() {
+    if (!file.isOpen()) return;
+
+    // entries must be on disk before the header says the file was closed cleanly
+    file.flush();
+    static_cast<FileHeader*>(file.data())->open = 0;
+    file.flush(0, sizeof(FileHeader));
+}
+
+ProofNumberTable::FileStatus ProofNumberTable::openFile(const std::string& path, uint64_t stamp) {
+    static_assert(sizeof(FileHeader) == 64, "table file header must stay 64 bytes");
+    static const char magic[8] = "SOLTTAB";
+
+    if (file.isOpen()) return FileStatus::Failed;
+    std::size_t bytes = sizeof(FileHeader) + entryCount * sizeof(Entry);
+    MappedFile::OpenStatus opened = file.open(path, bytes);
+    if (opened == MappedFile::OpenStatus::InUse) return FileStatus::InUse;
+    if (opened != MappedFile::OpenStatus::Opened) return FileStatus::Failed;
+
+    FileHeader* header = static_cast<FileHeader*>(file.data());
+    bool existed = file.previousSize() > 0;
+    bool compatible = file.previousSize() == bytes
+        && std::memcmp(header->magic, magic, sizeof(magic)) == 0
+        && header->version == formatVersion
+        && header->entrySize == sizeof(Entry)
+        && header->entryCount == entryCount
+        && header->stamp == stamp
+        && header->open == 0;
+
+    if (!compatible) {
+        std::memset(file.data(), 0, bytes);
+        std::memcpy(header->magic, magic, sizeof(magic));
+        header->version = formatVersion;
+        header->entrySize = sizeof(Entry);
+        header->entryCount = entryCount;
+        header->stamp = stamp;
+    }
+    header->open = 1;
+    file.flush(0, sizeof(FileHeader));
+
+    entries = reinterpret_cast<Entry*>(static_cast<char*>(file.data()) + sizeof(FileHeader));
+    memory.clear();
+    memory.shrink_to_fit();
+
+    if (compatible) return FileStatus::Reused;
+    return existed ? FileStatus::Stale : FileStatus::Created;
+}
+
+const ProofNumberTable::Entry* ProofNumberTable::find(uint64_t key) const {
+    const Entry* bucket = &entries[(key & bucketMask) * bucketSize];
+    for (std::size_t i = 0; i < bucketSize; i++) {
+        if (bucket[i].key == key) return &bucket[i];
+    }
+    return nullptr;
+}
+
+bool ProofNumberTable::store(const Entry& entry) {
+    Entry* bucket = &entries[(entry.key & bucketMask) * bucketSize];
+    Entry* victim = nullptr;
+
+    for (std::size_t i = 0; i < bucketSize; i++) {
+        Entry& candidate = bucket[i];
+        if (candidate.key == entry.key || candidate.key == 0) {
+            victim = &candidate;
+            break;
+        }
+        // proofs are needed later to rebuild the winning line, so estimates go first
+        bool candidateProven = candidate.pn == 0;
+        if (victim == nullptr) {
+            victim = &candidate;
+            continue;
+        }
+        bool victimProven = victim->pn == 0;
+        if (victimProven != candidateProven) {
+            if (victimProven) victim = &candidate;
+        }
+        else if (candidate.work < victim->work) {
+            victim = &candidate;
+        }
+    }
+
+    bool evicted = victim->key != 0 && victim->key != entry.key;
+    *victim = entry;
+    return evicted;
+}
+
+ProofNumberSearch::ProofNumberSearch(uint64_t maxNodes, int maxRecycles, std::size_t memoryBytes, int maxDepth)
+    : table(memoryBytes), maxNodes(maxNodes), maxRecycles(maxRecycles), maxDepth(maxDepth) {
+}
+
+SolveResult ProofNumberSearch::solve(const Game& root) {
+    nodes = 0;
+    aborted = false;
+    if (stats == &ownStats) ownStats.start();
+    path.clear();
+    solution.clear();
+
+    if (root.isGameWon()) return SolveResult::Won;
+
+    // a deal proven by an earlier search, possibly in an earlier run, needs no search
+    uint64_t rootKey = SearchUtil::stateKey(root);
+    stats->ttProbes++;
+    if (const ProofNumberTable::Entry* entry = table.find(rootKey)) {
+        stats->ttHits++;
+        SolveResult known = SolveResult::Unknown;
+        if (entry->pn == 0) {
+            extractSolution(root);
+            if (!solution.empty()) known = SolveResult::Won;
+        }
+        else if (entry->dn == 0) {
+            known = SolveResult::Lost;
+        }
+        if (known != SolveResult::Unknown) {
+            if (stats == &ownStats) ownStats.finish();
+            return known;
+        }
+    }
+
+    Value value = mid(root, rootKey, 0, infinity, infinity);
+    SolveResult result = SolveResult::Unknown;
+    if (value.pn == 0) {
+        extractSolution(root);
+        result = SolveResult::Won;
+    }
+    else if (value.dn == 0 && value.dependency >= 0) {
+        result = SolveResult::Lost;
+    }
+    if (stats == &ownStats) ownStats.finish();
+    return result;
+}
+
+ProofNumberSearch::Value ProofNumberSearch::mid(const Game& game, uint64_t key, int depth, uint32_t thpn, uint32_t thdn) {
+    // positions past the depth limit are disproven with a dependency no ancestor can resolve
+    if (depth >= maxDepth) {
+        stats->prune(SolverStats::DepthLimit);
+        return { infinity, 0, 0, -1 };
+    }
+    if (aborted || nodes >= maxNodes || (stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed))) {
+        aborted = true;
+        return { 1, 1, 0, noDependency };
+    }
+    nodes++;
+    uint64_t startNodes = nodes;
+    path[key] = depth;
+
+    std::vector<Child> children;
+    for (const Move& move : SearchUtil::searchMoves(game, maxRecycles)) {
+        Child child{ game, move, 0, 1, 1, 0, noDependency };
+        child.game.applyMove(move);
+
+        if (child.game.isGameWon()) {
+            child.pn = 0;
+            child.dn = infinity;
+        }
+        else {
+            child.key = SearchUtil::stateKey(child.game);
+            auto onPath = path.find(child.key);
+            if (onPath != path.end()) {
+                stats->prune(SolverStats::Repetition);
+                child.pn = infinity;
+                child.dn = 0;
+                child.dependency = onPath->second;
+            }
+            else if (DeadEndAnalyzer::isDeadEnd(child.game)) {
+                // a frozen board is lost whatever path led to it
+                stats->prune(SolverStats::DeadEnd);
+                child.pn = infinity;
+                child.dn = 0;
+            }
+            else {
+                stats->ttProbes++;
+                if (const ProofNumberTable::Entry* entry = table.find(child.key)) {
+                    stats->ttHits++;
+                    child.pn = entry->pn;
+                    child.dn = entry->dn;
+                    child.distance = entry->distance;
+                }
+            }
+        }
+        children.push_back(child);
+    }
+    stats->recordNode(depth, children.size());
+
+    Value value{ infinity, 0, 0, noDependency };
+    while (!children.empty()) {
+        value = { infinity, 0, infinity, noDependency };
+        Child* best = nullptr;
+        uint32_t secondPn = infinity;
+
+        for (Child& child : children) {
+            value.dn = addCapped(value.dn, child.dn);
+            if (child.pn == 0) value.distance = std::min(value.distance, child.distance + 1);
+            if (child.dn == 0) value.dependency = std::min(value.dependency, child.dependency);
+
+            if (best == nullptr || child.pn < best->pn || (child.pn == best->pn && child.dn < best->dn)) {
+                if (best != nullptr) secondPn = std::min(secondPn, best->pn);
+                best = &child;
+            }
+            else {
+                secondPn = std::min(secondPn, child.pn);
+            }
+        }
+        value.pn = best->pn;
+
+        if (value.pn == 0 || value.dn == 0 || value.pn >= thpn || value.dn >= thdn || aborted) break;
+
+        uint32_t childThpn = std::min(thpn, addCapped(secondPn, 1));
+        uint32_t childThdn = thdn >= infinity ? infinity : addCapped(thdn - value.dn, best->dn);
+
+        Value childValue = mid(best->game, best->key, depth + 1, childThpn, childThdn);
+        best->pn = childValue.pn;
+        best->dn = childValue.dn;
+        best->distance = childValue.distance;
+        best->dependency = childValue.dependency;
+    }
+    if (value.pn != 0) value.distance = 0;
+
+    path.erase(key);
+
+    uint32_t work = static_cast<uint32_t>(std::min<uint64_t>(nodes - startNodes + 1, 0xFFFFFFFFu));
+    if (value.dn == 0) {
+        // a repetition of this position itself is resolved here, repetitions of ancestors are not
+        if (value.dependency >= depth) {
+            value.dependency = noDependency;
+            storeEntry({ key, infinity, 0, work, 0 });
+        }
+    }
+    else {
+        storeEntry({ key, value.pn, value.dn, work, value.distance });
+    }
+    return value;
+}
+
+void ProofNumberSearch::storeEntry(const ProofNumberTable::Entry& entry) {
+    stats->ttStores++;
+    if (table.store(entry)) stats->ttEvictions++;
+}
+
+void ProofNumberSearch::extractSolution(const Game& root) {
+    Game game = root;
+    bool retried = false;
+
+    while (!game.isGameWon() && solution.size() < static_cast<std::size_t>(maxDepth)) {
+        Move next{};
+        bool found = false;
+        uint32_t bestDistance = infinity;
+
+        for (const Move& move : SearchUtil::searchMoves(game, maxRecycles)) {
+            Game child = game;
+            child.applyMove(move);
+            if (child.isGameWon()) {
+                next = move;
+                found = true;
+                break;
+            }
+            const ProofNumberTable::Entry* entry = table.find(SearchUtil::stateKey(child));
+            if (entry != nullptr && entry->pn == 0 && entry->distance < bestDistance) {
+                bestDistance = entry->distance;
+                next = move;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            // part of the proof was evicted from the table, prove this position again
+            if (retried) {
+                solution.clear();
+                return;
+            }
+            retried = true;
+            if (aborted) {
+                solution.clear();
+                return;
+            }
+            path.clear();
+            mid(game, SearchUtil::stateKey(game), 0, infinity, infinity);
+            continue;
+        }
+
+        solution.push_back(next);
+        game.applyMove(next);
+        retried = false;
+    }
+}
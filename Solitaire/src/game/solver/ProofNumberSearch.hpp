@@ -0,0 +1,259 @@
+#pragma once
+#include "SearchUtil.hpp"
+#include "SolverStats.hpp"
+#include "../util/mappedFile.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file ProofNumberSearch.hpp
+ * @brief Declares depth-first proof-number search, a solver mode aimed at proving deals unwinnable.
+ */
+
+/**
+ * @class ProofNumberTable
+ * @brief Fixed-size transposition table for proof and disproof numbers.
+ *
+ * The whole table is allocated once from a memory budget and never grows. Entries are grouped
+ * in buckets of four; when a bucket is full the entry with the least search work behind it is
+ * replaced, so expensive proofs survive while cheap estimates are recycled.
+ *
+ * The table can live in a memory-mapped file instead, so proofs survive between runs. The file
+ * is locked while it is mapped, so a second process using the same path keeps its table in memory.
+ */
+class ProofNumberTable {
+public:
+    /// Layout version of table files, bump when the rules, state keys or Entry change.
+    static const uint32_t formatVersion = 1;
+
+    /**
+     * @enum FileStatus
+     * @brief Outcome of mapping the table to a file.
+     */
+    enum class FileStatus : unsigned char {
+        Failed,   ///< The file could not be mapped, the table stays in memory.
+        InUse,    ///< Another process holds the file, the table stays in memory.
+        Created,  ///< A new empty table file was created.
+        Reused,   ///< A matching table file was found and its entries are used.
+        Stale     ///< The file held an incompatible or unfinished table and was cleared.
+    };
+
+    /**
+     * @brief Single stored position.
+     */
+    struct Entry {
+        uint64_t key;       ///< State key, 0 for an empty entry.
+        uint32_t pn;        ///< Proof number, 0 when proven won.
+        uint32_t dn;        ///< Disproof number, 0 when proven lost.
+        uint32_t work;      ///< Number of nodes expanded below this entry.
+        uint32_t distance;  ///< Moves to the win for proven entries.
+    };
+
+    /**
+     * @brief Allocates the table.
+     * @param memoryBytes Memory budget in bytes.
+     */
+    explicit ProofNumberTable(std::size_t memoryBytes);
+
+    /**
+     * @brief Writes a mapped table back to its file and marks it as cleanly closed.
+     */
+    ~ProofNumberTable();
+
+    ProofNumberTable(const ProofNumberTable&) = delete;
+    ProofNumberTable& operator=(const ProofNumberTable&) = delete;
+
+    /**
+     * @brief Moves the table into a memory-mapped file, reusing its entries when they are compatible.
+     *
+     * The file header stores the format version, entry size and count, a stamp of the search
+     * settings and a flag cleared on clean close. A mismatch of any of them, including a file left
+     * open by a crash, makes the file stale and it is cleared.
+     *
+     * @param path Path to the table file.
+     * @param stamp Search settings the stored results depend on.
+     * @return How the file was opened.
+     */
+    FileStatus openFile(const std::string& path, uint64_t stamp);
+
+    /**
+     * @brief Finds an entry by key.
+     * @param key State key.
+     * @return Pointer to the entry, nullptr if not stored.
+     */
+    const Entry* find(uint64_t key) const;
+
+    /**
+     * @brief Stores an entry, replacing the cheapest one in its bucket if needed.
+     * @param entry Entry to store.
+     * @return True if another position was evicted to make room.
+     */
+    bool store(const Entry& entry);
+
+    /**
+     * @brief Gets the memory used by the table.
+     * @return Size in bytes.
+     */
+    std::size_t memoryUsage() const { return entryCount * sizeof(Entry); }
+
+private:
+    /**
+     * @brief First 64 bytes of a table file.
+     */
+    struct FileHeader {
+        char magic[8];         ///< "SOLTTAB" and a terminating zero.
+        uint32_t version;      ///< formatVersion of the writer.
+        uint32_t entrySize;    ///< sizeof(Entry) of the writer.
+        uint64_t entryCount;   ///< Number of entries following the header.
+        uint64_t stamp;        ///< Search settings of the stored results.
+        uint32_t open;         ///< Set while a process uses the file.
+        uint32_t reserved[7];  ///< Zero, keeps the header 64 bytes long.
+    };
+
+    static const std::size_t bucketSize = 4; ///< Entries per bucket.
+    std::vector<Entry> memory;                ///< Storage of an in-memory table.
+    MappedFile file;                          ///< Storage of a file-backed table.
+    Entry* entries;                           ///< All buckets, laid out contiguously.
+    std::size_t entryCount;                   ///< Number of entries.
+    std::size_t bucketMask;                   ///< Mask selecting a bucket from a key.
+};
+
+/**
+ * @class ProofNumberSearch
+ * @brief Depth-first proof-number search (df-pn) over seeded games.
+ *
+ * Every position is an OR node: it is won if any move leads to a win, so its proof number is
+ * the minimum and its disproof number the sum over its children. The search always expands the
+ * most-proving child within thresholds, which quickly finds short wins and, when none exists,
+ * disproves whole subtrees without ordering heuristics.
+ *
+ * A position repeated on the current path counts as lost for that path. Disproofs that rely on
+ * such a repetition are only kept in the parent's local child list and never enter the table,
+ * so a Lost result is exact even though moves can be undone.
+ */
+class ProofNumberSearch {
+public:
+    /**
+     * @brief Creates a search.
+     * @param maxNodes Node expansion limit, after which the result is Unknown.
+     * @param maxRecycles Maximum number of pile recycles in a solution.
+     * @param memoryBytes Memory budget of the transposition table.
+     * @param maxDepth Longest path searched; deeper positions make the result Unknown instead of Lost.
+     */
+    ProofNumberSearch(uint64_t maxNodes, int maxRecycles, std::size_t memoryBytes, int maxDepth = 1000);
+
+    /**
+     * @brief Solves a game.
+     * @param root Position to solve.
+     * @return Result of the search.
+     */
+    SolveResult solve(const Game& root);
+
+    /**
+     * @brief Sets a flag that cancels the search when raised, making the result Unknown.
+     * @param flag Flag polled once per expanded position, nullptr to disable.
+     */
+    void setStopFlag(const std::atomic<bool>* flag) { stopFlag = flag; }
+
+    /**
+     * @brief Gets the winning move sequence of the last Won result.
+     * @return Moves from the root to the win.
+     */
+    const std::vector<Move>& getSolution() const { return solution; }
+
+    /**
+     * @brief Gets the number of positions expanded by the last search.
+     * @return Node count.
+     */
+    uint64_t getNodeCount() const { return nodes; }
+
+    /**
+     * @brief Keeps the transposition table in a file so later runs start from its proofs.
+     *
+     * Stored proofs depend on the recycle limit, which is part of the file stamp. Call before the
+     * first solve, entries stored in memory earlier are dropped.
+     *
+     * @param path Path to the table file.
+     * @return How the file was opened.
+     */
+    ProofNumberTable::FileStatus openTable(const std::string& path) {
+        return table.openFile(path, static_cast<uint64_t>(maxRecycles));
+    }
+
+    /**
+     * @brief Redirects telemetry to external statistics, e.g. those of the owning Solver.
+     * @param target Statistics to update, nullptr to keep them internal.
+     */
+    void setStats(SolverStats* target) { stats = target != nullptr ? target : &ownStats; }
+
+    /**
+     * @brief Gets the telemetry of the last search.
+     * @return Search statistics.
+     */
+    const SolverStats& getStats() const { return *stats; }
+
+private:
+    /// Dependency value of results that do not rely on the current path.
+    static const int noDependency = 0x7FFFFFFF;
+
+    /**
+     * @brief Proof state of a child in the parent's local list.
+     */
+    struct Child {
+        Game game;          ///< Position after the move.
+        Move move;          ///< Move leading to the position.
+        uint64_t key;       ///< State key.
+        uint32_t pn;        ///< Proof number.
+        uint32_t dn;        ///< Disproof number.
+        uint32_t distance;  ///< Moves to the win when proven.
+        int dependency;     ///< Shallowest path depth a disproof relies on.
+    };
+
+    /**
+     * @brief Result of searching a position.
+     */
+    struct Value {
+        uint32_t pn;        ///< Proof number.
+        uint32_t dn;        ///< Disproof number.
+        uint32_t distance;  ///< Moves to the win when proven.
+        int dependency;     ///< Shallowest path depth a disproof relies on.
+    };
+
+    /**
+     * @brief Searches a position until its proof or disproof number reaches a threshold.
+     * @param game Position to search.
+     * @param key State key of the position.
+     * @param depth Path depth of the position.
+     * @param thpn Proof number threshold.
+     * @param thdn Disproof number threshold.
+     * @return Proof state of the position.
+     */
+    Value mid(const Game& game, uint64_t key, int depth, uint32_t thpn, uint32_t thdn);
+
+    /**
+     * @brief Stores an entry in the table and counts evictions.
+     * @param entry Entry to store.
+     */
+    void storeEntry(const ProofNumberTable::Entry& entry);
+
+    /**
+     * @brief Rebuilds the winning line by following proven positions with decreasing distance.
+     * @param root Proven root position.
+     */
+    void extractSolution(const Game& root);
+
+    ProofNumberTable table;                  ///< Transposition table.
+    std::unordered_map<uint64_t, int> path;  ///< Keys on the current path with their depth.
+    std::vector<Move> solution;              ///< Winning line of the last search.
+    uint64_t maxNodes;                       ///< Node expansion limit.
+    uint64_t nodes = 0;                      ///< Nodes expanded by the current search.
+    int maxRecycles;                         ///< Recycle limit.
+    int maxDepth;                            ///< Path depth limit.
+    bool aborted = false;                    ///< Set when the node limit was hit or the search was cancelled.
+    const std::atomic<bool>* stopFlag = nullptr; ///< Cancellation flag.
+    SolverStats ownStats;                    ///< Telemetry when no external statistics are set.
+    SolverStats* stats = &ownStats;          ///< Telemetry being updated.
+};
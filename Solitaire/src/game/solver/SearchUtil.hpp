@@ -0,0 +1,91 @@
+#pragma once
+#include "../Game.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file SearchUtil.hpp
+ * @brief Shared definitions for solvers: results, state keys and move generation.
+ */
+
+/**
+ * @enum SolveResult
+ * @brief Outcome of solving a deal.
+ */
+enum class SolveResult : unsigned char {
+    Won,     ///< A winning move sequence was found.
+    Lost,    ///< Every reachable position was searched without a win.
+    Unknown  ///< The search stopped on a limit or was cancelled.
+};
+
+/**
+ * @namespace SearchUtil
+ * @brief Helpers used by every search strategy.
+ *
+ * Solvers search copies of a seeded Game, so recycling the pile replays the deck's
+ * seeded shuffle sequence and is deterministic. The number of recycles is part of
+ * the state and is capped, otherwise the state space would be unbounded.
+ */
+namespace SearchUtil {
+
+    /**
+     * @brief Gets how many times the pile was recycled in a game.
+     * @param game Game to inspect.
+     * @return Number of recycles since the deal.
+     */
+    inline int recycleCount(const Game& game) {
+        unsigned int shuffles = game.getDeck().getShuffleCount();
+        return shuffles > 0 ? static_cast<int>(shuffles) - 1 : 0;
+    }
+
+    /**
+     * @brief Computes the transposition key of a state: its canonical hash mixed with the recycle count.
+     * @param game Game to hash.
+     * @return 64-bit state key.
+     */
+    inline uint64_t stateKey(const Game& game) {
+        return game.canonicalHash() ^ (static_cast<uint64_t>(recycleCount(game)) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    /**
+     * @brief Lists the moves a solver considers, including recycling while under the limit.
+     * @param game Game to generate moves for.
+     * @param maxRecycles Maximum number of recycles allowed in a solution.
+     * @return Legal moves.
+     */
+    inline std::vector<Move> searchMoves(const Game& game, int maxRecycles) {
+        return game.getLegalMoves(recycleCount(game) < maxRecycles);
+    }
+
+    /**
+     * @brief Checks if a move takes the cards of the previous move back where they came from.
+     * @param move Move to check.
+     * @param last Previous move.
+     * @return True for the reverse of a column, column-to-reserve or reserve-to-column move.
+     */
+    inline bool undoes(const Move& move, const Move& last) {
+        switch (move.type) {
+        case MoveType::ColumnToColumn:
+            return last.type == MoveType::ColumnToColumn && move.from == last.to && move.to == last.from && move.count == last.count;
+        case MoveType::ColumnToReserve:
+            return last.type == MoveType::ReserveToColumn && move.from == last.to && move.to == last.from;
+        case MoveType::ReserveToColumn:
+            return last.type == MoveType::ColumnToReserve && move.from == last.to && move.to == last.from;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief Gets a readable name of a result.
+     * @param result Solve result.
+     * @return Name used in reports.
+     */
+    inline const char* resultName(SolveResult result) {
+        switch (result) {
+        case SolveResult::Won:  return "won";
+        case SolveResult::Lost: return "lost";
+        default:                return "unknown";
+        }
+    }
+}
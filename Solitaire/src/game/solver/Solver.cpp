@@ -0,0 +1,210 @@
+#include "Solver.hpp"
+#include "DeadEndAnalyzer.hpp"
+#include <algorithm>
+#include <queue>
+#include <string>
+#include <unordered_set>
+
+/**
+ * @brief Ranks a move for the greedy depth-first order, lower is tried first.
+ *
+ * Moves that turn a face-down card over come first, moves that only shuffle a
+ * whole column onto an empty one come last.
+ */
+static int movePriority(const Game& game, const Move& move) {
+    switch (move.type) {
+    case MoveType::ColumnToColumn: {
+        const std::vector<Card>& from = game.getColumn(move.from);
+        if (move.count == from.size())
+            return game.getColumn(move.to).empty() ? 9 : 2;
+        return from[from.size() - move.count - 1].isFacingUp() ? 3 : 0;
+    }
+    case MoveType::PileToColumn:
+        return 1;
+    case MoveType::ColumnToReserve: {
+        const std::vector<Card>& from = game.getColumn(move.from);
+        return from.size() > 1 && !from[from.size() - 2].isFacingUp() ? 1 : 5;
+    }
+    case MoveType::ReserveToColumn:
+        return 4;
+    case MoveType::PileToReserve:
+        return 5;
+    case MoveType::Draw:
+        return 6;
+    case MoveType::Recycle:
+        return 7;
+    }
+    return 8;
+}
+
+/// @brief Generates search moves sorted by movePriority.
+static std::vector<Move> orderedMoves(const Game& game, int maxRecycles) {
+    std::vector<Move> moves = SearchUtil::searchMoves(game, maxRecycles);
+    std::stable_sort(moves.begin(), moves.end(), [&game](const Move& a, const Move& b) {
+        return movePriority(game, a) < movePriority(game, b);
+    });
+    return moves;
+}
+
+Solver::Solver(const SolverOptions& options) : options(options) {
+    if (options.mode != SolverMode::ProofNumber) return;
+
+    proofSearch = std::make_unique<ProofNumberSearch>(options.maxNodes, options.maxRecycles, options.memoryMb * 1024 * 1024);
+    if (!options.tablePath.empty()) tableStatus = proofSearch->openTable(options.tablePath);
+}
+
+bool Solver::parseMode(const std::string& name, SolverMode& mode) {
+    if (name == "dfs") mode = SolverMode::DepthFirst;
+    else if (name == "best") mode = SolverMode::BestFirst;
+    else if (name == "pns") mode = SolverMode::ProofNumber;
+    else return false;
+    return true;
+}
+
+SolveResult Solver::solve(const Game& root) {
+    solution.clear();
+    stats.start();
+
+    SolveResult result;
+    switch (options.mode) {
+    case SolverMode::BestFirst:   result = solveBestFirst(root); break;
+    case SolverMode::ProofNumber: result = solveProofNumber(root); break;
+    default:                      result = solveDepthFirst(root); break;
+    }
+    stats.finish();
+    return result;
+}
+
+SolveResult Solver::solveDepthFirst(const Game& root) {
+    if (root.isGameWon()) return SolveResult::Won;
+
+    struct Frame {
+        Game game;
+        std::vector<Move> moves;
+        std::size_t next;
+    };
+
+    std::unordered_set<uint64_t> visited;
+    std::vector<Frame> stack;
+    visited.insert(SearchUtil::stateKey(root));
+    stats.ttStores++;
+    stack.push_back({ root, orderedMoves(root, options.maxRecycles), 0 });
+    stats.recordNode(0, stack.back().moves.size());
+
+    while (!stack.empty()) {
+        Frame& top = stack.back();
+        if (top.next == top.moves.size()) {
+            stack.pop_back();
+            continue;
+        }
+
+        Move move = top.moves[top.next++];
+        Game child = top.game;
+        child.applyMove(move);
+
+        if (child.isGameWon()) {
+            for (const Frame& frame : stack) {
+                solution.push_back(frame.moves[frame.next - 1]);
+            }
+            return SolveResult::Won;
+        }
+
+        stats.ttProbes++;
+        if (!visited.insert(SearchUtil::stateKey(child)).second) {
+            stats.ttHits++;
+            stats.prune(SolverStats::Duplicate);
+            continue;
+        }
+        stats.ttStores++;
+        if (DeadEndAnalyzer::isDeadEnd(child)) {
+            stats.prune(SolverStats::DeadEnd);
+            continue;
+        }
+        if (stats.nodes >= options.maxNodes || stopped()) return SolveResult::Unknown;
+
+        std::vector<Move> moves = orderedMoves(child, options.maxRecycles);
+        stats.recordNode(static_cast<int>(stack.size()), moves.size());
+        stack.push_back({ std::move(child), std::move(moves), 0 });
+    }
+
+    return SolveResult::Lost;
+}
+
+SolveResult Solver::solveBestFirst(const Game& root) {
+    if (root.isGameWon()) return SolveResult::Won;
+
+    // every expanded position keeps only its parent and move, the line is rebuilt on a win
+    struct Node {
+        int64_t parent;
+        Move move;
+        int depth;
+    };
+    struct Entry {
+        int score;
+        uint64_t order;
+        int64_t node;
+        Game game;
+    };
+    auto worse = [](const Entry& a, const Entry& b) {
+        return a.score != b.score ? a.score < b.score : a.order > b.order;
+    };
+
+    std::vector<Node> tree;
+    std::unordered_set<uint64_t> visited;
+    std::priority_queue<Entry, std::vector<Entry>, decltype(worse)> open(worse);
+    const Evaluator& evaluator = options.evaluator != nullptr ? *options.evaluator : defaultEvaluator;
+    uint64_t order = 0;
+
+    tree.push_back({ -1, Move{}, 0 });
+    visited.insert(SearchUtil::stateKey(root));
+    stats.ttStores++;
+    open.push({ evaluator.evaluate(root), order++, 0, root });
+
+    while (!open.empty()) {
+        if (stats.nodes >= options.maxNodes || stopped()) return SolveResult::Unknown;
+        Entry entry = open.top();
+        open.pop();
+
+        std::vector<Move> moves = SearchUtil::searchMoves(entry.game, options.maxRecycles);
+        int depth = tree[entry.node].depth;
+        stats.recordNode(depth, moves.size());
+
+        for (const Move& move : moves) {
+            Game child = entry.game;
+            child.applyMove(move);
+            stats.ttProbes++;
+            if (!visited.insert(SearchUtil::stateKey(child)).second) {
+                stats.ttHits++;
+                stats.prune(SolverStats::Duplicate);
+                continue;
+            }
+            stats.ttStores++;
+            if (DeadEndAnalyzer::isDeadEnd(child)) {
+                stats.prune(SolverStats::DeadEnd);
+                continue;
+            }
+
+            tree.push_back({ entry.node, move, depth + 1 });
+            int64_t node = static_cast<int64_t>(tree.size()) - 1;
+
+            if (child.isGameWon()) {
+                for (int64_t i = node; tree[i].parent >= 0; i = tree[i].parent) {
+                    solution.push_back(tree[i].move);
+                }
+                std::reverse(solution.begin(), solution.end());
+                return SolveResult::Won;
+            }
+            open.push({ evaluator.evaluate(child), order++, node, std::move(child) });
+        }
+    }
+
+    return SolveResult::Lost;
+}
+
+SolveResult Solver::solveProofNumber(const Game& root) {
+    proofSearch->setStopFlag(stopFlag);
+    proofSearch->setStats(&stats);
+    SolveResult result = proofSearch->solve(root);
+    solution = proofSearch->getSolution();
+    return result;
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include "Evaluator.hpp"
+#include "SearchUtil.hpp"
+#include "SolverStats.hpp"
+#include "ProofNumberSearch.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file Solver.hpp
+ * @brief Declares the Solver class which decides whether a seeded deal can be won.
+ */
+
+/**
+ * @enum SolverMode
+ * @brief Search strategy used by the Solver.
+ */
+enum class SolverMode : unsigned char {
+    DepthFirst,   ///< Depth-first search with greedy move ordering and a visited set.
+    BestFirst,    ///< Best-first search expanding the position with the best heuristic score.
+    ProofNumber   ///< Depth-first proof-number search, see ProofNumberSearch.
+};
+
+/**
+ * @struct SolverOptions
+ * @brief Limits and strategy of a Solver.
+ */
+struct SolverOptions {
+    SolverMode mode = SolverMode::DepthFirst; ///< Search strategy.
+    uint64_t maxNodes = 2000000;              ///< Positions expanded before giving up.
+    int maxRecycles = 2;                      ///< Pile recycles allowed in a solution.
+    std::size_t memoryMb = 64;                ///< Memory budget of the transposition table.
+    const Evaluator* evaluator = nullptr;     ///< Scores positions for best-first search, nullptr for WeightedEvaluator defaults.
+    std::string tablePath;                    ///< File keeping the proof-number table between runs, empty to keep it in memory.
+};
+
+/**
+ * @class Solver
+ * @brief Searches for a winning move sequence from a position.
+ *
+ * The depth-first mode is the main solver: it tries moves in greedy order and remembers every
+ * expanded position, so a Lost result means no position reachable within the recycle limit is won.
+ *
+ * The proof-number mode keeps its table for the lifetime of the Solver, so solving several
+ * deals with one Solver reuses proofs of shared positions.
+ */
+class Solver {
+public:
+    /**
+     * @brief Creates a solver.
+     * @param options Strategy and limits.
+     */
+    explicit Solver(const SolverOptions& options = SolverOptions());
+
+    /**
+     * @brief Solves a position.
+     * @param root Position to solve, usually a freshly dealt seeded game.
+     * @return Result of the search.
+     */
+    SolveResult solve(const Game& root);
+
+    /**
+     * @brief Gets the winning move sequence of the last Won result.
+     * @return Moves from the root to the win.
+     */
+    const std::vector<Move>& getSolution() const { return solution; }
+
+    /**
+     * @brief Gets the number of positions expanded by the last search.
+     * @return Node count.
+     */
+    uint64_t getNodeCount() const { return stats.nodes; }
+
+    /**
+     * @brief Gets the telemetry of the last search.
+     * @return Search statistics.
+     */
+    const SolverStats& getStats() const { return stats; }
+
+    /**
+     * @brief Sets a callback reporting statistics while searching.
+     * @param callback Progress callback, empty to disable.
+     * @param interval Expanded positions between calls.
+     */
+    void setProgressCallback(const SolverStats::ProgressCallback& callback, uint64_t interval = 100000) {
+        stats.setProgressCallback(callback, interval);
+    }
+
+    /**
+     * @brief Sets a flag that cancels the search when raised, making the result Unknown.
+     * @param flag Flag polled once per expanded position, nullptr to disable.
+     */
+    void setStopFlag(const std::atomic<bool>* flag) { stopFlag = flag; }
+
+    /**
+     * @brief Parses a mode name used on the command line.
+     * @param name "dfs", "best" or "pns".
+     * @param mode Parsed mode.
+     * @return True if the name is known.
+     */
+    static bool parseMode(const std::string& name, SolverMode& mode);
+
+    /**
+     * @brief Gets how the table file of the proof-number mode was opened.
+     * @return File status, Failed when no table file is used.
+     */
+    ProofNumberTable::FileStatus getTableStatus() const { return tableStatus; }
+
+private:
+    /**
+     * @brief Runs the depth-first search.
+     * @param root Position to solve.
+     * @return Result of the search.
+     */
+    SolveResult solveDepthFirst(const Game& root);
+
+    /**
+     * @brief Runs the best-first search.
+     * @param root Position to solve.
+     * @return Result of the search.
+     */
+    SolveResult solveBestFirst(const Game& root);
+
+    /**
+     * @brief Checks if the search was cancelled through the stop flag.
+     */
+    bool stopped() const { return stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Runs the proof-number search.
+     * @param root Position to solve.
+     * @return Result of the search.
+     */
+    SolveResult solveProofNumber(const Game& root);
+
+    SolverOptions options;       ///< Strategy and limits.
+    WeightedEvaluator defaultEvaluator; ///< Evaluator used when the options give none.
+    std::vector<Move> solution;  ///< Winning line of the last search.
+    SolverStats stats;           ///< Telemetry of the last search.
+    const std::atomic<bool>* stopFlag = nullptr; ///< Cancellation flag.
+    std::unique_ptr<ProofNumberSearch> proofSearch; ///< Proof-number search kept between solves.
+    ProofNumberTable::FileStatus tableStatus = ProofNumberTable::FileStatus::Failed; ///< Table file status.
+};
@@ -0,0 +1,96 @@
+#include "SolverStats.hpp"
+#include <sstream>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/// Names of prune rules used in the JSON summary.
+static const char* pruneRuleNames[SolverStats::PruneRuleCount] = { "duplicate", "repetition", "depth_limit", "dead_end" };
+
+void SolverStats::start() {
+    ProgressCallback callback = progress;
+    uint64_t interval = progressInterval;
+    *this = SolverStats();
+    progress = callback;
+    progressInterval = interval;
+    startTime = std::chrono::steady_clock::now();
+}
+
+void SolverStats::recordNode(int depth, std::size_t children) {
+    nodes++;
+    if (depth >= 0) {
+        if (nodesAtDepth.size() <= static_cast<std::size_t>(depth)) {
+            nodesAtDepth.resize(depth + 1, 0);
+            childrenAtDepth.resize(depth + 1, 0);
+        }
+        nodesAtDepth[depth]++;
+        childrenAtDepth[depth] += children;
+    }
+
+    if (progress && nodes % progressInterval == 0) {
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        peakMemoryBytes = processPeakMemory();
+        progress(*this);
+    }
+}
+
+void SolverStats::finish() {
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    peakMemoryBytes = processPeakMemory();
+}
+
+void SolverStats::setProgressCallback(const ProgressCallback& callback, uint64_t interval) {
+    progress = callback;
+    progressInterval = interval > 0 ? interval : 1;
+}
+
+double SolverStats::nodesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(nodes) / seconds : 0.0;
+}
+
+double SolverStats::branchingFactor(std::size_t depth) const {
+    if (depth >= nodesAtDepth.size() || nodesAtDepth[depth] == 0) return 0.0;
+    return static_cast<double>(childrenAtDepth[depth]) / static_cast<double>(nodesAtDepth[depth]);
+}
+
+std::string SolverStats::toJson() const {
+    std::ostringstream out;
+    out << "{\"nodes\":" << nodes
+        << ",\"seconds\":" << seconds
+        << ",\"nodes_per_second\":" << nodesPerSecond()
+        << ",\"tt\":{\"probes\":" << ttProbes
+        << ",\"hits\":" << ttHits
+        << ",\"hit_rate\":" << (ttProbes > 0 ? static_cast<double>(ttHits) / ttProbes : 0.0)
+        << ",\"stores\":" << ttStores
+        << ",\"evictions\":" << ttEvictions
+        << ",\"eviction_rate\":" << (ttStores > 0 ? static_cast<double>(ttEvictions) / ttStores : 0.0)
+        << "},\"pruned\":{";
+    for (int i = 0; i < PruneRuleCount; i++) {
+        out << (i > 0 ? "," : "") << "\"" << pruneRuleNames[i] << "\":" << pruned[i];
+    }
+    out << "},\"branching\":[";
+    for (std::size_t depth = 0; depth < nodesAtDepth.size(); depth++) {
+        out << (depth > 0 ? "," : "") << branchingFactor(depth);
+    }
+    out << "],\"peak_memory_bytes\":" << peakMemoryBytes << "}";
+    return out.str();
+}
+
+std::size_t SolverStats::processPeakMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+    }
+    return 0;
+#endif
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file SolverStats.hpp
+ * @brief Declares SolverStats, the telemetry collected by every solver mode.
+ */
+
+/**
+ * @struct SolverStats
+ * @brief Counters describing a single search, reported live and as a JSON summary.
+ *
+ * Transposition counters cover the visited sets of the depth-first and best-first modes and
+ * the table of proof-number search. An eviction is a store that replaced a different position,
+ * which only happens in the fixed-size proof-number table.
+ */
+struct SolverStats {
+    /**
+     * @enum PruneRule
+     * @brief Reasons a child position was not searched.
+     */
+    enum PruneRule {
+        Duplicate,       ///< Already searched through another line.
+        Repetition,      ///< Repeats a position on the current path.
+        DepthLimit,      ///< Lies beyond the path depth limit.
+        DeadEnd,         ///< Proven lost by DeadEndAnalyzer.
+        PruneRuleCount   ///< Number of rules.
+    };
+
+    /// Callback invoked with the current statistics while searching.
+    using ProgressCallback = std::function<void(const SolverStats&)>;
+
+    uint64_t nodes = 0;                          ///< Positions expanded.
+    uint64_t ttProbes = 0;                       ///< Transposition lookups.
+    uint64_t ttHits = 0;                         ///< Lookups that found the position.
+    uint64_t ttStores = 0;                       ///< Transposition stores.
+    uint64_t ttEvictions = 0;                    ///< Stores that evicted another position.
+    uint64_t pruned[PruneRuleCount] = {};        ///< Pruned children per rule.
+    std::vector<uint64_t> nodesAtDepth;          ///< Expanded positions per depth.
+    std::vector<uint64_t> childrenAtDepth;       ///< Generated children per depth.
+    double seconds = 0.0;                        ///< Time since start.
+    std::size_t peakMemoryBytes = 0;             ///< Peak memory of the process.
+
+    /**
+     * @brief Resets all counters and starts the clock.
+     */
+    void start();
+
+    /**
+     * @brief Records an expanded position, reporting progress when the interval is reached.
+     * @param depth Path depth of the position.
+     * @param children Number of generated moves.
+     */
+    void recordNode(int depth, std::size_t children);
+
+    /**
+     * @brief Records a pruned child.
+     * @param rule Reason of pruning.
+     */
+    void prune(PruneRule rule) { pruned[rule]++; }
+
+    /**
+     * @brief Stops the clock and samples peak memory.
+     */
+    void finish();
+
+    /**
+     * @brief Sets a callback called every given number of expanded positions.
+     * @param callback Progress callback, empty to disable.
+     * @param interval Positions between calls.
+     */
+    void setProgressCallback(const ProgressCallback& callback, uint64_t interval = 100000);
+
+    /**
+     * @brief Gets the search speed.
+     * @return Expanded positions per second.
+     */
+    double nodesPerSecond() const;
+
+    /**
+     * @brief Gets the average number of children of positions at a depth.
+     * @param depth Path depth.
+     * @return Branching factor, 0 if nothing was expanded there.
+     */
+    double branchingFactor(std::size_t depth) const;
+
+    /**
+     * @brief Formats all counters as a single-line JSON object.
+     * @return JSON text.
+     */
+    std::string toJson() const;
+
+    /**
+     * @brief Gets the peak resident memory of the process.
+     * @return Size in bytes, 0 if the platform does not report it.
+     */
+    static std::size_t processPeakMemory();
+
+private:
+    std::chrono::steady_clock::time_point startTime; ///< Start of the search.
+    ProgressCallback progress;                       ///< Live progress callback.
+    uint64_t progressInterval = 100000;              ///< Positions between progress calls.
+};
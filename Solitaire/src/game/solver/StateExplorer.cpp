@@ -0,0 +1,228 @@
+#include "StateExplorer.hpp"
+#include "../util/fs.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <queue>
+
+/// Size of read and write buffers used for layer files.
+static const std::size_t ioBufferSize = 1 << 20;
+/// Maximum number of run files merged at once.
+static const std::size_t maxMergeWidth = 64;
+/// Estimated per-state overhead of std::string in memory, used for the budget.
+static const std::size_t stateOverhead = 32;
+
+/// @brief Writes a packed state as its length followed by its bytes.
+static void writeState(BufferedIO::BufferedFileWriter& writer, const std::string& state) {
+    writer.writeInt(static_cast<int32_t>(state.size()));
+    writer.write(state.data(), static_cast<std::streamsize>(state.size()));
+}
+
+/// @brief Reads a packed state written by writeState.
+/// @return False at the end of the file.
+static bool readState(BufferedIO::BufferedFileReader& reader, std::string& state) {
+    int32_t size = reader.readInt();
+    if (size < 0) return false;
+    state.resize(size);
+    return reader.read(state.data(), size) == size;
+}
+
+StateExplorer::StateExplorer(const std::string& workDir, std::size_t memoryBudget, bool canonical)
+    : workDir(workDir), memoryBudget(memoryBudget), canonical(canonical) {
+    std::filesystem::create_directories(workDir);
+}
+
+std::string StateExplorer::pack(const Game& game) const {
+    return canonical ? game.packCanonicalState() : game.packState();
+}
+
+std::string StateExplorer::tempPath(const std::string& prefix) {
+    return (std::filesystem::path(workDir) / (prefix + std::to_string(tempCounter++) + ".bin")).string();
+}
+
+uint64_t StateExplorer::sortUnique(const std::string& input, const std::string& output) {
+    std::vector<std::string> runs;
+    {
+        BufferedIO::BufferedFileReader reader(input, ioBufferSize);
+        std::vector<std::string> states;
+        std::size_t used = 0;
+        std::string state;
+
+        auto flushRun = [&]() {
+            std::sort(states.begin(), states.end());
+            states.erase(std::unique(states.begin(), states.end()), states.end());
+
+            std::string run = tempPath("run");
+            BufferedIO::BufferedFileWriter writer(run, ioBufferSize);
+            for (const std::string& s : states) {
+                writeState(writer, s);
+            }
+            writer.flush();
+            runs.push_back(run);
+            states.clear();
+            used = 0;
+        };
+
+        while (readState(reader, state)) {
+            used += state.size() + stateOverhead;
+            states.push_back(state);
+            if (used >= memoryBudget) flushRun();
+        }
+        if (!states.empty() || runs.empty()) flushRun();
+    }
+    std::filesystem::remove(input);
+
+    return mergeRuns(runs, output);
+}
+
+uint64_t StateExplorer::mergeRuns(const std::vector<std::string>& runs, const std::string& output) {
+    std::vector<std::string> pending = runs;
+    while (pending.size() > maxMergeWidth) {
+        std::vector<std::string> merged;
+        for (std::size_t i = 0; i < pending.size(); i += maxMergeWidth) {
+            std::size_t end = std::min(pending.size(), i + maxMergeWidth);
+            std::string run = tempPath("run");
+            mergeRuns(std::vector<std::string>(pending.begin() + i, pending.begin() + end), run);
+            merged.push_back(run);
+        }
+        pending = merged;
+    }
+
+    uint64_t written = 0;
+    {
+        std::vector<std::unique_ptr<BufferedIO::BufferedFileReader>> readers;
+        std::vector<std::string> heads(pending.size());
+
+        using Entry = std::pair<const std::string*, std::size_t>;
+        auto greater = [](const Entry& a, const Entry& b) { return *a.first > *b.first; };
+        std::priority_queue<Entry, std::vector<Entry>, decltype(greater)> queue(greater);
+
+        for (std::size_t i = 0; i < pending.size(); i++) {
+            readers.push_back(std::make_unique<BufferedIO::BufferedFileReader>(pending[i], ioBufferSize / maxMergeWidth + 4096));
+            if (readState(*readers[i], heads[i])) queue.push({ &heads[i], i });
+        }
+
+        BufferedIO::BufferedFileWriter writer(output, ioBufferSize);
+        std::string last;
+        bool hasLast = false;
+        while (!queue.empty()) {
+            std::size_t index = queue.top().second;
+            queue.pop();
+
+            if (!hasLast || heads[index] != last) {
+                writeState(writer, heads[index]);
+                last = heads[index];
+                hasLast = true;
+                written++;
+            }
+            if (readState(*readers[index], heads[index])) queue.push({ &heads[index], index });
+        }
+        writer.flush();
+    }
+
+    for (const std::string& run : pending) {
+        std::filesystem::remove(run);
+    }
+    return written;
+}
+
+uint64_t StateExplorer::subtractVisited(const std::string& layer, const std::string& visited,
+    const std::string& fresh, const std::string& visitedOut) {
+    BufferedIO::BufferedFileReader layerReader(layer, ioBufferSize);
+    BufferedIO::BufferedFileReader visitedReader(visited, ioBufferSize);
+    BufferedIO::BufferedFileWriter freshWriter(fresh, ioBufferSize);
+    BufferedIO::BufferedFileWriter visitedWriter(visitedOut, ioBufferSize);
+
+    std::string a, b;
+    bool hasA = readState(layerReader, a);
+    bool hasB = readState(visitedReader, b);
+    uint64_t count = 0;
+
+    while (hasA || hasB) {
+        if (hasA && (!hasB || a < b)) {
+            writeState(freshWriter, a);
+            writeState(visitedWriter, a);
+            count++;
+            hasA = readState(layerReader, a);
+        }
+        else if (hasB && (!hasA || b < a)) {
+            writeState(visitedWriter, b);
+            hasB = readState(visitedReader, b);
+        }
+        else {
+            writeState(visitedWriter, b);
+            hasA = readState(layerReader, a);
+            hasB = readState(visitedReader, b);
+        }
+    }
+
+    freshWriter.flush();
+    visitedWriter.flush();
+    return count;
+}
+
+std::vector<StateExplorer::LayerReport> StateExplorer::explore(const Game& root, int maxDepth,
+    const std::function<void(const LayerReport&)>& onLayer) {
+    std::vector<LayerReport> reports;
+
+    std::string layer = tempPath("layer");
+    std::string visited = tempPath("visited");
+    {
+        BufferedIO::BufferedFileWriter layerWriter(layer, ioBufferSize);
+        BufferedIO::BufferedFileWriter visitedWriter(visited, ioBufferSize);
+        writeState(layerWriter, pack(root));
+        writeState(visitedWriter, pack(root));
+        layerWriter.flush();
+        visitedWriter.flush();
+    }
+
+    uint64_t layerSize = 1;
+    uint64_t visitedCount = 1;
+    for (int depth = 0; layerSize > 0; depth++) {
+        std::string children = tempPath("children");
+        uint64_t wonStates = 0;
+        {
+            BufferedIO::BufferedFileReader reader(layer, ioBufferSize);
+            BufferedIO::BufferedFileWriter writer(children, ioBufferSize);
+            std::string state;
+            Game game;
+
+            while (readState(reader, state)) {
+                game.unpackState(state);
+                if (game.isGameWon()) {
+                    wonStates++;
+                    continue;
+                }
+                if (maxDepth >= 0 && depth >= maxDepth) continue;
+
+                for (const Move& move : game.getLegalMoves()) {
+                    Game child = game;
+                    if (child.applyMove(move)) writeState(writer, pack(child));
+                }
+            }
+            writer.flush();
+        }
+        std::filesystem::remove(layer);
+
+        LayerReport report{ depth, layerSize, wonStates, visitedCount };
+        reports.push_back(report);
+        if (onLayer) onLayer(report);
+
+        std::string sorted = tempPath("sorted");
+        sortUnique(children, sorted);
+
+        std::string next = tempPath("layer");
+        std::string nextVisited = tempPath("visited");
+        layerSize = subtractVisited(sorted, visited, next, nextVisited);
+        visitedCount += layerSize;
+
+        std::filesystem::remove(sorted);
+        std::filesystem::remove(visited);
+        layer = next;
+        visited = nextVisited;
+    }
+
+    std::filesystem::remove(layer);
+    std::filesystem::remove(visited);
+    return reports;
+}
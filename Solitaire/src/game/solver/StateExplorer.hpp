@@ -0,0 +1,101 @@
+#pragma once
+#include "../Game.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file StateExplorer.hpp
+ * @brief Declares the StateExplorer class, a disk-backed breadth-first explorer of reachable game states.
+ */
+
+/**
+ * @class StateExplorer
+ * @brief Counts every position reachable from a deal, layer by layer, keeping frontiers on disk.
+ *
+ * Each BFS layer is stored as a file of packed states (see Game::packState). Children of a layer
+ * are written unsorted, then sorted and deduplicated with an external merge sort that never holds
+ * more than the memory budget, and finally merged against the sorted file of all visited states.
+ * Only states that were never seen before form the next layer, so the layer sizes are exact.
+ *
+ * With canonical packing (the default) positions that differ only in column order are merged,
+ * see Game::packCanonicalState, so the counts are of distinct positions up to column order.
+ *
+ * Recycling the pile reshuffles it randomly, so it is not a deterministic transition and is left out.
+ */
+class StateExplorer {
+public:
+    /**
+     * @brief Size report of a single BFS layer.
+     */
+    struct LayerReport {
+        int depth;           ///< Number of moves from the deal.
+        uint64_t states;     ///< Distinct states first reached at this depth.
+        uint64_t wonStates;  ///< States in this layer for which Game::isGameWon holds.
+        uint64_t visited;    ///< Distinct states reached up to and including this depth.
+    };
+
+    /**
+     * @brief Creates an explorer working in the given directory.
+     * @param workDir Directory for layer and run files, created if missing.
+     * @param memoryBudget Approximate number of bytes of states kept in memory while sorting.
+     * @param canonical Whether states are stored in canonical column order.
+     */
+    StateExplorer(const std::string& workDir, std::size_t memoryBudget = 256u * 1024u * 1024u, bool canonical = true);
+
+    /**
+     * @brief Explores all states reachable from the given game.
+     * @param root Starting position.
+     * @param maxDepth Last depth to explore, negative for no limit.
+     * @param onLayer Optional callback invoked after every finished layer.
+     * @return Reports of all explored layers.
+     */
+    std::vector<LayerReport> explore(const Game& root, int maxDepth = -1,
+        const std::function<void(const LayerReport&)>& onLayer = nullptr);
+
+private:
+    std::string workDir;      ///< Directory holding temporary files.
+    std::size_t memoryBudget; ///< Bytes of states allowed in memory during sorting.
+    bool canonical;           ///< Whether states are packed with Game::packCanonicalState.
+    int tempCounter = 0;      ///< Counter used to name temporary files.
+
+    /**
+     * @brief Packs a state in the form used by the layer files.
+     * @param game Game to pack.
+     */
+    std::string pack(const Game& game) const;
+
+    /**
+     * @brief Returns a new unique path inside the work directory.
+     * @param prefix File name prefix.
+     */
+    std::string tempPath(const std::string& prefix);
+
+    /**
+     * @brief Sorts a file of states and removes duplicates using sorted runs and k-way merges.
+     * @param input Unsorted input file, removed afterwards.
+     * @param output Sorted, deduplicated output file.
+     * @return Number of states written.
+     */
+    uint64_t sortUnique(const std::string& input, const std::string& output);
+
+    /**
+     * @brief Merges sorted run files into one sorted file without duplicates, removing the runs.
+     * @param runs Sorted run files.
+     * @param output Output file.
+     * @return Number of states written.
+     */
+    uint64_t mergeRuns(const std::vector<std::string>& runs, const std::string& output);
+
+    /**
+     * @brief Splits a sorted layer into states not yet visited and merges it into the visited set.
+     * @param layer Sorted candidate states.
+     * @param visited Sorted visited states.
+     * @param fresh Output file for states not present in visited.
+     * @param visitedOut Output file for the union of both inputs.
+     * @return Number of fresh states.
+     */
+    uint64_t subtractVisited(const std::string& layer, const std::string& visited,
+        const std::string& fresh, const std::string& visitedOut);
+};
@@ -0,0 +1,95 @@
+#include "Tuner.hpp"
+#include "GreedyBot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+Tuner::Tuner(const TuneOptions& options) : options(options) {}
+
+Tuner::GameOutcome Tuner::playGame(const Evaluator& evaluator, unsigned int seed, int maxMoves, int maxRecycles) {
+    Game game;
+    game.reset(seed);
+
+    GreedyBot bot(evaluator, maxRecycles);
+    bot.reset(game);
+    GameOutcome outcome{ false, WeightedEvaluator::extract(game).kingRunCards, 0 };
+
+    while (outcome.moves < maxMoves && bot.step(game)) {
+        outcome.moves++;
+        if (game.isGameWon()) {
+            outcome.won = true;
+            outcome.progress = 52;
+            break;
+        }
+        outcome.progress = std::max(outcome.progress, WeightedEvaluator::extract(game).kingRunCards);
+    }
+    return outcome;
+}
+
+double Tuner::fitness(const WeightedEvaluator::Weights& weights) const {
+    WeightedEvaluator evaluator(weights);
+    double total = 0.0;
+    for (unsigned int i = 0; i < options.games; i++) {
+        GameOutcome outcome = playGame(evaluator, options.firstSeed + i, options.maxMoves, options.maxRecycles);
+        total += outcome.won ? 100.0 : outcome.progress;
+    }
+    return options.games > 0 ? total / options.games : 0.0;
+}
+
+std::vector<double> Tuner::rate(const std::vector<WeightedEvaluator::Weights>& candidates) const {
+    std::vector<double> results(candidates.size(), 0.0);
+    std::atomic<std::size_t> next(0);
+
+    int threadCount = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount < 1) threadCount = 1;
+    if (static_cast<std::size_t>(threadCount) > candidates.size()) threadCount = static_cast<int>(candidates.size());
+
+    // every worker takes the next unrated candidate until none is left
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back([&]() {
+            for (std::size_t index = next++; index < candidates.size(); index = next++) {
+                results[index] = fitness(candidates[index]);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return results;
+}
+
+WeightedEvaluator::Weights Tuner::tune(const WeightedEvaluator::Weights& start, const RoundCallback& callback) {
+    std::mt19937 random(options.randomSeed);
+    std::uniform_int_distribution<int> pickWeight(0, WeightedEvaluator::Weights::count - 1);
+    std::uniform_int_distribution<int> pickDelta(1, options.step > 0 ? options.step : 1);
+
+    WeightedEvaluator::Weights best = start;
+    double bestFitness = rate({ best })[0];
+    if (callback) callback(0, bestFitness, best);
+
+    for (int round = 1; round <= options.rounds; round++) {
+        std::vector<WeightedEvaluator::Weights> candidates;
+        for (int i = 0; i < options.candidates; i++) {
+            WeightedEvaluator::Weights candidate = best;
+            // change one or two weights, each up or down by at most step
+            int changes = 1 + static_cast<int>(random() % 2);
+            for (int j = 0; j < changes; j++) {
+                int delta = pickDelta(random);
+                candidate[pickWeight(random)] += random() % 2 == 0 ? delta : -delta;
+            }
+            candidates.push_back(candidate);
+        }
+
+        std::vector<double> results = rate(candidates);
+        for (std::size_t i = 0; i < candidates.size(); i++) {
+            if (results[i] > bestFitness) {
+                bestFitness = results[i];
+                best = candidates[i];
+            }
+        }
+        if (callback) callback(round, bestFitness, best);
+    }
+    return best;
+}
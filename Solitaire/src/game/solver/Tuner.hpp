@@ -0,0 +1,90 @@
+#pragma once
+#include "Evaluator.hpp"
+#include <functional>
+#include <vector>
+
+/**
+ * @file Tuner.hpp
+ * @brief Declares the Tuner class which searches for better WeightedEvaluator weights by self-play.
+ */
+
+/**
+ * @struct TuneOptions
+ * @brief Size of the self-play batches and of the weight search.
+ */
+struct TuneOptions {
+    unsigned int firstSeed = 0;  ///< First seed of the game batch.
+    unsigned int games = 200;    ///< Games played with every weight vector.
+    int rounds = 20;             ///< Rounds of the weight search.
+    int candidates = 8;          ///< Weight vectors tried per round.
+    int threads = 0;             ///< Worker threads, 0 for one per hardware thread.
+    int maxMoves = 400;          ///< Moves per game before the bot gives up.
+    int maxRecycles = 2;         ///< Pile recycles allowed per game.
+    int step = 2;                ///< Largest change of a single weight.
+    unsigned int randomSeed = 1; ///< Seed of the weight perturbations.
+};
+
+/**
+ * @class Tuner
+ * @brief Tunes evaluator weights with a hill climb over batches of greedy self-play games.
+ *
+ * Every candidate plays the same seeded deals with a greedy bot that always takes the move
+ * to the best scored position it has not seen yet. Candidates of a round are played in
+ * parallel. The fitness does not depend on the weights being tuned: a won game is worth 100,
+ * any other game the number of cards it got into King runs.
+ */
+class Tuner {
+public:
+    /**
+     * @brief Result of a single self-play game.
+     */
+    struct GameOutcome {
+        bool won;      ///< Whether the bot won.
+        int progress;  ///< Most cards in King runs reached during the game.
+        int moves;     ///< Moves played.
+    };
+
+    /// Callback invoked with the round number, best fitness and best weights, round 0 being the start weights.
+    using RoundCallback = std::function<void(int, double, const WeightedEvaluator::Weights&)>;
+
+    /**
+     * @brief Creates a tuner.
+     * @param options Batch and search sizes.
+     */
+    explicit Tuner(const TuneOptions& options = TuneOptions());
+
+    /**
+     * @brief Runs the weight search.
+     * @param start Initial weights.
+     * @param callback Called once the start weights are rated, as round 0, and after every round, may be empty.
+     * @return Best weights found.
+     */
+    WeightedEvaluator::Weights tune(const WeightedEvaluator::Weights& start, const RoundCallback& callback = RoundCallback());
+
+    /**
+     * @brief Plays the whole game batch with the given weights.
+     * @param weights Weights to rate.
+     * @return Average fitness per game.
+     */
+    double fitness(const WeightedEvaluator::Weights& weights) const;
+
+    /**
+     * @brief Plays one seeded game with a greedy bot.
+     * @param evaluator Evaluator guiding the bot.
+     * @param seed Seed of the deal.
+     * @param maxMoves Moves before giving up.
+     * @param maxRecycles Pile recycles allowed.
+     * @return Outcome of the game.
+     */
+    static GameOutcome playGame(const Evaluator& evaluator, unsigned int seed, int maxMoves, int maxRecycles);
+
+private:
+    /**
+     * @brief Rates several weight vectors in parallel.
+     * @param candidates Weight vectors to rate.
+     * @return Fitness of every candidate, in the same order.
+     */
+    std::vector<double> rate(const std::vector<WeightedEvaluator::Weights>& candidates) const;
+
+    TuneOptions options; ///< Batch and search sizes.
+};
@@ -0,0 +1,120 @@
+#include "BoardCanvas.hpp"
+#include "../util/colorUtil.hpp"
+#include <algorithm>
+
+/// Unchanged cells between two changed ones that are written again instead of moving the cursor,
+/// a cursor move costs 6 to 8 bytes and a cell 1 to 3.
+static const int maxGap = 3;
+
+/// Character of a shown cell whose content is unknown, so it differs from every cell.
+static const wchar_t unknownCharacter = L'\0';
+
+void BoardCanvas::reset(int columns, int rows, const std::wstring& background) {
+    this->columns = columns;
+    this->rows = rows;
+    styles.assign(1, background);
+    styleIds.clear();
+    styleIds[background] = 0;
+    cells.assign(static_cast<std::size_t>(columns) * rows, Cell());
+    shown.assign(cells.size(), Cell{ unknownCharacter, 0 });
+}
+
+void BoardCanvas::grow(int rows) {
+    if (rows <= this->rows) return;
+    this->rows = rows;
+    cells.resize(static_cast<std::size_t>(columns) * rows, Cell());
+    // rows the canvas did not cover may hold anything, so they are written in full
+    shown.resize(cells.size(), Cell{ unknownCharacter, 0 });
+}
+
+void BoardCanvas::clear(int x, int y, int width, int height) {
+    for (int row = std::max(y, 0); row < std::min(y + height, rows); row++) {
+        for (int column = std::max(x, 0); column < std::min(x + width, columns); column++) {
+            cells[static_cast<std::size_t>(row) * columns + column] = Cell();
+        }
+    }
+}
+
+void BoardCanvas::set(int x, int y, const std::wstring& text) {
+    if (y < 0 || y >= rows) return;
+
+    uint16_t style = 0;
+    std::size_t i = 0;
+    while (i < text.size()) {
+        if (text[i] == L'\x1b' && i + 1 < text.size() && text[i + 1] == L'[') {
+            // parameters and intermediates up to the final character
+            std::size_t end = i + 2;
+            while (end < text.size() && (text[end] < 0x40 || text[end] > 0x7E)) end++;
+            if (end >= text.size()) break;
+            if (text[end] == L'm') style = intern(text.substr(i, end - i + 1));
+            i = end + 1;
+            continue;
+        }
+
+        if (x >= 0 && x < columns) {
+            cells[static_cast<std::size_t>(y) * columns + x] = Cell{ text[i], style };
+        }
+        x++;
+        i++;
+    }
+}
+
+std::wstring BoardCanvas::diff() {
+    std::wstring out;
+    int currentStyle = -1;
+
+    auto differs = [this](std::size_t index) {
+        return cells[index] != shown[index];
+    };
+    auto writeCell = [&](std::size_t index) {
+        const Cell& cell = cells[index];
+        if (cell.style != currentStyle) {
+            // the empty background of the None color mode needs an explicit reset
+            out += styles[cell.style].empty() ? ColorUtil::RESET : styles[cell.style];
+            currentStyle = cell.style;
+        }
+        out += cell.character;
+        shown[index] = cell;
+    };
+
+    for (int row = 0; row < rows; row++) {
+        std::size_t rowStart = static_cast<std::size_t>(row) * columns;
+        int column = 0;
+        while (column < columns) {
+            if (!differs(rowStart + column)) {
+                column++;
+                continue;
+            }
+
+            out += cursorTo(column, row);
+            while (column < columns) {
+                if (differs(rowStart + column)) {
+                    writeCell(rowStart + column);
+                    column++;
+                    continue;
+                }
+                // a short gap is cheaper to write again than to jump over
+                int next = column;
+                while (next < columns && next - column <= maxGap && !differs(rowStart + next)) next++;
+                if (next >= columns || next - column > maxGap) break;
+                for (; column < next; column++) writeCell(rowStart + column);
+            }
+        }
+    }
+
+    return out;
+}
+
+std::wstring BoardCanvas::cursorTo(int x, int y) {
+    return L"\x1b[" + std::to_wstring(y + 1) + L";" + std::to_wstring(x + 1) + L"H";
+}
+
+uint16_t BoardCanvas::intern(const std::wstring& sgr) {
+    auto found = styleIds.find(sgr);
+    if (found != styleIds.end()) return found->second;
+
+    uint16_t id = static_cast<uint16_t>(styles.size());
+    styles.push_back(sgr);
+    styleIds.emplace(sgr, id);
+    return id;
+}
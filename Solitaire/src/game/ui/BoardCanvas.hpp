@@ -0,0 +1,121 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file BoardCanvas.hpp
+ * @brief Declares BoardCanvas, a grid of colored cells that writes only what changed on the terminal.
+ */
+
+/**
+ * @class BoardCanvas
+ * @brief Keeps the cells of the screen between frames and turns changes into minimal terminal output.
+ *
+ * Text is placed with set(), which understands the SGR color sequences of the color constants,
+ * and areas are blanked with clear(). The canvas remembers what the terminal shows, so diff()
+ * sends only the runs of cells that differ, each after a cursor move and with a color sequence
+ * only where the color changes. Callers redraw just the areas whose content changed; cells
+ * rewritten with the same content cost nothing.
+ */
+class BoardCanvas {
+public:
+    /**
+     * @brief Clears the canvas to the background and forgets what the terminal shows.
+     *
+     * The next diff() writes every cell, so it should follow a cleared screen.
+     *
+     * @param columns Width in cells.
+     * @param rows Height in cells.
+     * @param background SGR sequence of blank cells, empty for the terminal default.
+     */
+    void reset(int columns, int rows, const std::wstring& background);
+
+    /**
+     * @brief Adds blank rows at the bottom, the canvas never gets shorter until reset().
+     * @param rows New height, ignored if not larger.
+     */
+    void grow(int rows);
+
+    /**
+     * @brief Fills a rectangle with blank background cells, clipped to the canvas.
+     * @param x Left column.
+     * @param y Top row.
+     * @param width Width in cells.
+     * @param height Height in cells.
+     */
+    void clear(int x, int y, int width, int height);
+
+    /**
+     * @brief Writes text on one row, clipped to the canvas.
+     * @param x Column of the first character.
+     * @param y Row.
+     * @param text Characters with SGR sequences, which set the color of the characters after them.
+     */
+    void set(int x, int y, const std::wstring& text);
+
+    /**
+     * @brief Builds the output bringing the terminal from what it shows to the canvas.
+     *
+     * Cursor moves are absolute, so the output does not depend on where the cursor was.
+     * Afterwards the terminal is assumed to show the canvas.
+     *
+     * @return Escape sequences and text, empty if nothing changed.
+     */
+    std::wstring diff();
+
+    /**
+     * @brief Gets the width.
+     * @return Columns of the canvas.
+     */
+    int getColumns() const { return columns; }
+
+    /**
+     * @brief Gets the height.
+     * @return Rows of the canvas.
+     */
+    int getRows() const { return rows; }
+
+    /**
+     * @brief Gets the SGR sequence of blank cells.
+     * @return Background given to reset().
+     */
+    const std::wstring& getBackground() const { return styles[0]; }
+
+    /**
+     * @brief Builds an absolute cursor move.
+     * @param x Column, from 0.
+     * @param y Row, from 0.
+     * @return CUP sequence.
+     */
+    static std::wstring cursorTo(int x, int y);
+
+private:
+    /**
+     * @brief Character and color of one cell.
+     */
+    struct Cell {
+        wchar_t character = L' ';   ///< Shown character.
+        uint16_t style = 0;         ///< Index into styles, 0 for the background.
+
+        bool operator==(const Cell& other) const {
+            return character == other.character && style == other.style;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Gets the index of a color sequence, adding it if it is new.
+     * @param sgr Color sequence.
+     * @return Index into styles.
+     */
+    uint16_t intern(const std::wstring& sgr);
+
+    int columns = 0;                                       ///< Width in cells.
+    int rows = 0;                                          ///< Height in cells.
+    std::vector<Cell> cells;                               ///< Content, row by row.
+    std::vector<Cell> shown;                               ///< What the terminal shows, row by row, unknown cells hold '\0'.
+    std::vector<std::wstring> styles{ std::wstring() };    ///< Color sequences, the background first.
+    std::unordered_map<std::wstring, uint16_t> styleIds;   ///< Index of every color sequence.
+};
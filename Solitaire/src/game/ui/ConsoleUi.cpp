@@ -1,36 +1,70 @@
 #include "ConsoleUi.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <locale>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <string>
 #include "../util/MultiLineWStringBuilder.hpp"
 #include "../util/colorUtil.hpp"
+#include "../solver/DeadEndAnalyzer.hpp"
+#include "../util/rawInput.hpp"
+#include "../util/terminalScreen.hpp"
+#include "../util/terminalSize.hpp"
+#include "TileRenderer.hpp"
 #ifdef _WIN32 
 #include "../util/windowsConsole.hpp"
 #endif
 
 
 /// Black text on white background.
-static const std::wstring BLACK_FG_WHITE_BG = ColorUtil::wrgbBoth({ 0,0,0 }, { 245,247,250 });
+static std::wstring BLACK_FG_WHITE_BG;
 /// Red text on white background.
-static const std::wstring RED_FG_WHITE_BG = ColorUtil::wrgbBoth({ 255,0,0 }, { 255,255,255 });
+static std::wstring RED_FG_WHITE_BG;
 /// White text on green background.
-static const std::wstring WHITE_FG_GREEN_BG = ColorUtil::wrgbBoth({ 245,247,250 }, { 52,162,73 });
+static std::wstring WHITE_FG_GREEN_BG;
 /// Black text on green background.
-static const std::wstring BLACK_FG_GREEN_BG = ColorUtil::wrgbBoth({ 0,0,0 }, { 52,162,73 });
+static std::wstring BLACK_FG_GREEN_BG;
 /// White text on white background.
-static const std::wstring WHITE_FG_WHITE_BG = ColorUtil::wrgbBoth({ 245,247,250 }, { 245,247,250 });
+static std::wstring WHITE_FG_WHITE_BG;
 /// White text on dark green background.
-static const std::wstring WHITE_FG_DARK_GREEN_BG = ColorUtil::wrgbBoth({ 245,247,250 }, { 31, 97, 44 });
+static std::wstring WHITE_FG_DARK_GREEN_BG;
 /// Red text on dark green background.
-static const std::wstring RED_FG_DARK_GREEN_BG = ColorUtil::wrgbBoth({ 255,0,0 }, { 31, 97, 44 });
+static std::wstring RED_FG_DARK_GREEN_BG;
 /// Black text on dark green background.
-static const std::wstring BLACK_FG_DARK_GREEN_BG = ColorUtil::wrgbBoth({ 0,0,0 }, { 31, 97, 44 });
+static std::wstring BLACK_FG_DARK_GREEN_BG;
 /// White text on lighter dark green background.
-static const std::wstring WHITE_FG_LIGHTER_DARK_GREEN_BG = ColorUtil::wrgbBoth({ 255,255,255 }, { 42, 130, 58 });
+static std::wstring WHITE_FG_LIGHTER_DARK_GREEN_BG;
 
 
-ConsoleUi::ConsoleUi(Game& game) : game(game) {}
+/**
+ * @brief Builds the color constants in the active color mode, called once the terminal was detected.
+ */
+static void initColors() {
+    BLACK_FG_WHITE_BG = ColorUtil::wrgbBoth({ 0,0,0 }, { 245,247,250 });
+    RED_FG_WHITE_BG = ColorUtil::wrgbBoth({ 255,0,0 }, { 255,255,255 });
+    WHITE_FG_GREEN_BG = ColorUtil::wrgbBoth({ 245,247,250 }, { 52,162,73 });
+    BLACK_FG_GREEN_BG = ColorUtil::wrgbBoth({ 0,0,0 }, { 52,162,73 });
+    WHITE_FG_WHITE_BG = ColorUtil::wrgbBoth({ 245,247,250 }, { 245,247,250 });
+    WHITE_FG_DARK_GREEN_BG = ColorUtil::wrgbBoth({ 245,247,250 }, { 31, 97, 44 });
+    RED_FG_DARK_GREEN_BG = ColorUtil::wrgbBoth({ 255,0,0 }, { 31, 97, 44 });
+    BLACK_FG_DARK_GREEN_BG = ColorUtil::wrgbBoth({ 0,0,0 }, { 31, 97, 44 });
+    WHITE_FG_LIGHTER_DARK_GREEN_BG = ColorUtil::wrgbBoth({ 255,255,255 }, { 42, 130, 58 });
+}
+
+ConsoleUi::ConsoleUi(Game& game) : renderScheduler([this]() { drawScreen(); }), game(game) {
+    // start() builds them again once the terminal was detected, this makes draw() usable without it
+    initColors();
+    game.getEvents().subscribe(&ConsoleUi::onGameEvent, this);
+}
+
+ConsoleUi::~ConsoleUi() {
+    game.getEvents().unsubscribe(&ConsoleUi::onGameEvent, this);
+    renderScheduler.stop();
+    if (autosaveThread.joinable()) autosaveThread.join();
+}
 
 /// @brief Converts a rank enum to its string representation.
 /// @param rank The card rank.
@@ -99,131 +133,305 @@ static std::vector<std::wstring> cardToAsciiBox(const Card& card) {
     return lines;
 }
 
-void ConsoleUi::draw() {
-    int pileYOffset = 1;
-    MultiLineWStringBuilder builder(BLACK_FG_GREEN_BG);
-    builder.set(2, pileYOffset++, BLACK_FG_WHITE_BG + L"╔═══════╗");
-    builder.set(2, pileYOffset++, BLACK_FG_WHITE_BG + L"║ / / / ║");
-    builder.set(2, pileYOffset++, BLACK_FG_WHITE_BG + L"║/ / / /║");
-    builder.set(2, pileYOffset++, BLACK_FG_WHITE_BG + L"║ / / / ║");
-    builder.set(2, pileYOffset++, BLACK_FG_WHITE_BG + L"╚═══════╝");
-    pileYOffset++;
+/// Terminal columns needed by the full layout.
+static const int fullLayoutColumns = 114;
+/// Terminal rows needed by the full layout with its prompt, without long columns.
+static const int fullLayoutRows = 32;
 
-    std::vector<Card> pile = game.getPile();
+/// Pause in commands after which the game is saved.
+static const std::chrono::milliseconds autosaveDelay(500);
+/// Prompt shown when the game starts.
+static const std::string welcomeMessage = "wpisz komende aby zagrać jeżeli nie znasz komend wpisz \"pomoc\"";
 
-    for (int i = 0; i < pile.size(); i++) {
-        std::vector<std::wstring> cardLines = cardToAsciiBox(pile[i]);
-        if (i < pile.size() - 1) {
-            cardLines.pop_back();
-            cardLines.pop_back();
-        }
-        for (int j = 0; j < cardLines.size(); j++) {
-            builder.set(2, pileYOffset++, cardLines[j]);
-        }
+#ifndef _WIN32
+/**
+ * @brief Moves the first complete line of the input read so far into line.
+ * @param input Bytes read from standard input, the taken line and its line break are removed.
+ * @param line Receives the line without its line break.
+ * @return False if input holds no complete line.
+ */
+static bool takeLine(std::string& input, std::string& line) {
+    std::size_t end = input.find('\n');
+    if (end == std::string::npos) return false;
+    line = input.substr(0, end);
+    input.erase(0, end + 1);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return true;
+}
+#endif
+
+/**
+ * @brief Generates the compact form of a card: rank and suit in 3 cells.
+ * @param card The card to be drawn.
+ * @return Wide string with color codes, "░░░" for a card facing down.
+ */
+static std::wstring cardToCompact(const Card& card) {
+    if (!card.isFacingUp()) {
+        return BLACK_FG_WHITE_BG + L"░░░";
     }
+    std::wstring rank = rankToString(card.getRank());
+    std::wstring color = card.isRed() ? RED_FG_WHITE_BG : BLACK_FG_WHITE_BG;
+    return color + std::wstring(2 - rank.size(), L' ') + rank + suitToString(card.getSuit());
+}
 
-    int xOffset = 20;
-    for (int i = 0; i < game.columnsSize; i++) {
-        int yOffset = 1;
-        // column number
-        builder.set(xOffset + 4, 0, WHITE_FG_GREEN_BG + std::to_wstring(i + 1));
+void ConsoleUi::writeFrame(const std::wstring& frame) {
+    // shares the writer of the tile renderers, which sends UTF-8 bytes through std::cout outside
+    // Windows, so frames and the prompts printed with std::cout never mix stream orientations
+    auto start = std::chrono::steady_clock::now();
+    TileRenderer::write(frame);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-        std::vector<Card>& column = game.getColumn(i);
-        for (int j = 0; j < column.size(); j++) {
-            std::vector<std::wstring> cardLines = cardToAsciiBox(column[j]);
+    std::lock_guard<std::mutex> lock(frameMeterMutex);
+    frameMeter.record(frame, seconds);
+}
 
-            if (j < column.size() - 1) {
-                cardLines.pop_back();
-                cardLines.pop_back();
-            }
+bool ConsoleUi::useCompactLayout(CardLayout layout) {
+    if (layout != CardLayout::Auto) return layout == CardLayout::Compact;
 
-            for (int k = 0; k < cardLines.size(); k++) {
-                builder.set(xOffset, yOffset + k, cardLines[k]);
-            }
-            if (j < column.size() - 1) {
-                yOffset += 3;
-            }
-            else {
-                yOffset += 5;
-            }
+    TerminalSize::Size size;
+    if (!TerminalSize::query(size)) return false;
+    return size.columns < fullLayoutColumns || size.rows < fullLayoutRows;
+}
 
+/// Columns of the full layout board.
+static const int fullBoardColumns = 113;
+/// Columns of the compact layout board.
+static const int compactBoardColumns = 41;
+/// Left column of the deck and the pile in the full layout.
+static const int fullPileX = 2;
+/// First row of the pile in the full layout, under the deck.
+static const int fullPileY = 7;
+/// Left column of the first column in the full layout.
+static const int fullColumnsX = 20;
+/// Distance between columns in the full layout.
+static const int fullColumnStep = 10;
+/// Left column of the reserve frame in the full layout.
+static const int fullReserveX = 99;
+/// Distance between reserve slots in the full layout.
+static const int fullReserveStep = 6;
+/// Left column of the first column in the compact layout.
+static const int compactColumnsX = 6;
+/// Distance between columns in the compact layout.
+static const int compactColumnStep = 4;
+/// Left column of the reserve slots in the compact layout.
+static const int compactReserveX = 36;
+/// Distance between reserve slots in the compact layout.
+static const int compactReserveStep = 3;
+
+/**
+ * @brief Counts the rows cards take when stacked with 3 rows showing of every card but the last.
+ * @param cards Number of cards.
+ * @return Rows of the full layout stack.
+ */
+static int stackRows(std::size_t cards) {
+    return cards == 0 ? 0 : 3 * (static_cast<int>(cards) - 1) + 5;
+}
+
+/**
+ * @brief Counts the rows of the board, which grows with the longest column or the pile.
+ * @param shown Drawn game.
+ * @param compact True for the compact layout.
+ * @return Rows of the board.
+ */
+static int boardRows(const Game& shown, bool compact) {
+    int rows = compact ? 1 + (Game::reserveSlotSize - 1) * compactReserveStep + 2 : 2 + Game::reserveSlotSize * fullReserveStep + 2;
+    if (!compact) rows = (std::max)(rows, fullPileY + stackRows(shown.getPile().size()));
+    else rows = (std::max)(rows, 8);
+
+    for (int i = 0; i < Game::columnsSize; i++) {
+        std::size_t cards = shown.getColumn(i).size();
+        if (cards == 0) continue;
+        rows = (std::max)(rows, 1 + (compact ? static_cast<int>(cards) + 1 : stackRows(cards)));
+    }
+    return rows;
+}
+
+/**
+ * @brief Draws the parts of the board that never change: column and slot numbers, frames and the deck.
+ * @param canvas Canvas to draw on.
+ * @param compact True for the compact layout.
+ */
+static void drawBoardFrame(BoardCanvas& canvas, bool compact) {
+    if (compact) {
+        for (int i = 0; i < Game::columnsSize; i++) {
+            canvas.set(compactColumnsX + i * compactColumnStep + 1, 0, WHITE_FG_GREEN_BG + std::to_wstring(i + 1));
+        }
+        for (int i = 0; i < Game::reserveSlotSize; i++) {
+            canvas.set(compactReserveX + 4, 1 + i * compactReserveStep, WHITE_FG_GREEN_BG + std::to_wstring(i + 1));
         }
-        xOffset += 10;
+        return;
     }
-    xOffset += 9;
 
+    canvas.set(fullPileX, 1, BLACK_FG_WHITE_BG + L"╔═══════╗");
+    canvas.set(fullPileX, 2, BLACK_FG_WHITE_BG + L"║ / / / ║");
+    canvas.set(fullPileX, 3, BLACK_FG_WHITE_BG + L"║/ / / /║");
+    canvas.set(fullPileX, 4, BLACK_FG_WHITE_BG + L"║ / / / ║");
+    canvas.set(fullPileX, 5, BLACK_FG_WHITE_BG + L"╚═══════╝");
+
+    for (int i = 0; i < Game::columnsSize; i++) {
+        canvas.set(fullColumnsX + i * fullColumnStep + 4, 0, WHITE_FG_GREEN_BG + std::to_wstring(i + 1));
+    }
+
+    int xOffset = fullReserveX;
     int reserveYOffset = 1;
 
     // top lighter outline
-    builder.set(xOffset - 1, reserveYOffset, WHITE_FG_LIGHTER_DARK_GREEN_BG + L"             ");
+    canvas.set(xOffset - 1, reserveYOffset, WHITE_FG_LIGHTER_DARK_GREEN_BG + L"             ");
     reserveYOffset++;
-    for (int i = 0; i < game.reserveSlotSize; i++) {
-
-        std::wstring suitColor = i < 2 ? RED_FG_WHITE_BG : BLACK_FG_WHITE_BG;
-
-
+    for (int i = 0; i < Game::reserveSlotSize; i++) {
         //top
-        builder.set(xOffset, reserveYOffset, WHITE_FG_DARK_GREEN_BG + L"           ");
+        canvas.set(xOffset, reserveYOffset, WHITE_FG_DARK_GREEN_BG + L"           ");
 
         //bottom
-        builder.set(xOffset, reserveYOffset + 6, WHITE_FG_DARK_GREEN_BG + L"           ");
-
-
-        // left  top corner lighter outline
-        builder.set(xOffset - 1, reserveYOffset, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
-        
-         //right top corner lighter outline
-        builder.set(xOffset + 11, reserveYOffset, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
+        canvas.set(xOffset, reserveYOffset + 6, WHITE_FG_DARK_GREEN_BG + L"           ");
 
-        // left bottom corner lighter outline
-        builder.set(xOffset - 1, reserveYOffset + 6, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
-
-        //right bottom corner lighter outline
-        builder.set(xOffset + 11, reserveYOffset + 6, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
+        // corners of the lighter outline
+        canvas.set(xOffset - 1, reserveYOffset, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
+        canvas.set(xOffset + 11, reserveYOffset, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
+        canvas.set(xOffset - 1, reserveYOffset + 6, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
+        canvas.set(xOffset + 11, reserveYOffset + 6, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
 
         // slot number
-        builder.set(xOffset + 13, reserveYOffset + 3, WHITE_FG_GREEN_BG + std::to_wstring(i + 1));
+        canvas.set(xOffset + 13, reserveYOffset + 3, WHITE_FG_GREEN_BG + std::to_wstring(i + 1));
 
         for (int j = 0; j < 5; j++) {
+            // lighter and darker outlines on both sides
+            canvas.set(xOffset - 1, reserveYOffset + j + 1, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
+            canvas.set(xOffset + 11, reserveYOffset + j + 1, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
+            canvas.set(xOffset, reserveYOffset + j + 1, WHITE_FG_DARK_GREEN_BG + L" ");
+            canvas.set(xOffset + 10, reserveYOffset + j + 1, WHITE_FG_DARK_GREEN_BG + L" ");
+        }
+        reserveYOffset += fullReserveStep;
+    }
+    canvas.set(xOffset - 1, ++reserveYOffset, WHITE_FG_LIGHTER_DARK_GREEN_BG + L"             ");
+}
 
-            // left lighter outline
-            builder.set(xOffset - 1, reserveYOffset + j + 1, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
+/**
+ * @brief Clears one board region and draws it again.
+ * @param canvas Canvas to draw on.
+ * @param shown Drawn game.
+ * @param region Region index: the stock, a column or a reserve slot.
+ * @param compact True for the compact layout.
+ * @param rows Rows of the board, columns and the pile are cleared down to it.
+ */
+static void drawBoardRegion(BoardCanvas& canvas, const Game& shown, int region, bool compact, int rows) {
+    const int firstColumn = 1;
+    const int firstReserve = firstColumn + Game::columnsSize;
+
+    if (region < firstColumn) {
+        const std::vector<Card>& pile = shown.getPile();
+        if (compact) {
+            // deck and the top card of the pile, each with the number of cards under it
+            canvas.clear(1, 1, compactColumnsX - 2, 7);
+            canvas.set(1, 1, BLACK_FG_WHITE_BG + L"░░░");
+            canvas.set(1, 2, BLACK_FG_WHITE_BG + L"░░░");
+            canvas.set(1, 3, WHITE_FG_GREEN_BG + std::to_wstring(shown.getDeck().getCards().size()));
+            if (!pile.empty()) {
+                canvas.set(1, 5, cardToCompact(pile.back()));
+                canvas.set(1, 6, BLACK_FG_WHITE_BG + L"   ");
+                canvas.set(1, 7, WHITE_FG_GREEN_BG + std::to_wstring(pile.size()));
+            }
+            return;
+        }
 
-            //right lighter outline
-            builder.set(xOffset + 11, reserveYOffset + j + 1, WHITE_FG_LIGHTER_DARK_GREEN_BG + L" ");
-            
-            // left darker outline
-            builder.set(xOffset, reserveYOffset + j + 1, WHITE_FG_DARK_GREEN_BG + L" ");
-           
-            // right darker outline
-            builder.set(xOffset + 10, reserveYOffset + j + 1, WHITE_FG_DARK_GREEN_BG + L" ");
+        canvas.clear(fullPileX, fullPileY, 9, rows - fullPileY);
+        int y = fullPileY;
+        for (std::size_t i = 0; i < pile.size(); i++) {
+            std::vector<std::wstring> cardLines = cardToAsciiBox(pile[i]);
+            if (i < pile.size() - 1) cardLines.resize(3);
+            for (const std::wstring& line : cardLines) {
+                canvas.set(fullPileX, y++, line);
+            }
         }
+        return;
+    }
 
+    if (region < firstReserve) {
+        int index = region - firstColumn;
+        const std::vector<Card>& column = shown.getColumn(index);
+        if (compact) {
+            int x = compactColumnsX + index * compactColumnStep;
+            canvas.clear(x, 1, 3, rows - 1);
+            for (std::size_t j = 0; j < column.size(); j++) {
+                canvas.set(x, 1 + static_cast<int>(j), cardToCompact(column[j]));
+            }
+            // the top card gets a second line so it stands out from the cards under it
+            if (!column.empty()) {
+                canvas.set(x, 1 + static_cast<int>(column.size()), BLACK_FG_WHITE_BG + L"   ");
+            }
+            return;
+        }
 
+        int x = fullColumnsX + index * fullColumnStep;
+        canvas.clear(x, 1, 9, rows - 1);
+        int y = 1;
+        for (std::size_t j = 0; j < column.size(); j++) {
+            std::vector<std::wstring> cardLines = cardToAsciiBox(column[j]);
+            // cards under the top one show only their upper 3 rows
+            if (j < column.size() - 1) cardLines.resize(3);
+            for (std::size_t k = 0; k < cardLines.size(); k++) {
+                canvas.set(x, y + static_cast<int>(k), cardLines[k]);
+            }
+            y += 3;
+        }
+        return;
+    }
 
-        if (!game.getReserveSlot(i).isValid()) {
-            builder.set(xOffset + 1, reserveYOffset + 1, BLACK_FG_WHITE_BG + L"┌───────┐");
-            builder.set(xOffset + 1, reserveYOffset + 2, BLACK_FG_WHITE_BG + L"│   " + suitColor + suitToString(static_cast<Suit>(i)) + BLACK_FG_WHITE_BG + L"   │");
-            builder.set(xOffset + 1, reserveYOffset + 3, BLACK_FG_WHITE_BG + L"│       │");
-            builder.set(xOffset + 1, reserveYOffset + 4, BLACK_FG_WHITE_BG + L"│       │");
-            builder.set(xOffset + 1, reserveYOffset + 5, BLACK_FG_WHITE_BG + L"└───────┘");
+    int slot = region - firstReserve;
+    const Card& card = shown.getReserveSlot(slot);
+    if (compact) {
+        int y = 1 + slot * compactReserveStep;
+        if (card.isValid()) {
+            canvas.set(compactReserveX, y, cardToCompact(card));
+            canvas.set(compactReserveX, y + 1, BLACK_FG_WHITE_BG + L"   ");
         }
         else {
-            std::vector<std::wstring> lines = cardToAsciiBox(game.getReserveSlot(i));
-            for (int j = 0; j < lines.size(); j++) {
-                builder.set(xOffset + 1, reserveYOffset + 1 + j, BLACK_FG_WHITE_BG + lines[j]);
-            }
+            std::wstring suitColor = slot < 2 ? RED_FG_DARK_GREEN_BG : BLACK_FG_DARK_GREEN_BG;
+            canvas.set(compactReserveX, y, suitColor + L" " + suitToString(static_cast<Suit>(slot)) + L" ");
+            canvas.set(compactReserveX, y + 1, WHITE_FG_DARK_GREEN_BG + L"   ");
         }
-        reserveYOffset += 6;
+        return;
     }
-    builder.set(xOffset - 1, ++reserveYOffset, WHITE_FG_LIGHTER_DARK_GREEN_BG + L"             ");  
 
-#ifdef _WIN32
-    WindowsConsole::WriteWStringToConsole(builder.str());
-#else   
-    std::wcout << builder.str();
-#endif
-    
+    // the card box inside the frame, which drawBoardFrame draws around it
+    int x = fullReserveX + 1;
+    int y = 2 + slot * fullReserveStep + 1;
+    if (!card.isValid()) {
+        std::wstring suitColor = slot < 2 ? RED_FG_WHITE_BG : BLACK_FG_WHITE_BG;
+        canvas.set(x, y, BLACK_FG_WHITE_BG + L"┌───────┐");
+        canvas.set(x, y + 1, BLACK_FG_WHITE_BG + L"│   " + suitColor + suitToString(static_cast<Suit>(slot)) + BLACK_FG_WHITE_BG + L"   │");
+        canvas.set(x, y + 2, BLACK_FG_WHITE_BG + L"│       │");
+        canvas.set(x, y + 3, BLACK_FG_WHITE_BG + L"│       │");
+        canvas.set(x, y + 4, BLACK_FG_WHITE_BG + L"└───────┘");
+    }
+    else {
+        std::vector<std::wstring> lines = cardToAsciiBox(card);
+        for (std::size_t j = 0; j < lines.size(); j++) {
+            canvas.set(x, y + static_cast<int>(j), lines[j]);
+        }
+    }
+}
+
+void ConsoleUi::drawCompact(const Game& shown) {
+    draw(shown, CardLayout::Compact);
+}
+
+void ConsoleUi::draw() {
+    draw(game, cardLayout);
+}
+
+void ConsoleUi::draw(const Game& shown, CardLayout layout) {
+    bool compact = useCompactLayout(layout);
+    int rows = boardRows(shown, compact);
+
+    // a fresh canvas knows nothing of the screen, so every cell of the board is written
+    BoardCanvas board;
+    board.reset(compact ? compactBoardColumns : fullBoardColumns, rows, BLACK_FG_GREEN_BG);
+    drawBoardFrame(board, compact);
+    for (int region = 0; region < boardRegionCount; region++) {
+        drawBoardRegion(board, shown, region, compact, rows);
+    }
+    writeFrame(board.diff());
 }
 
 
@@ -257,6 +465,197 @@ std::vector<std::string> Split(const std::string& s, char seperator)
     return output;
 }
 
+/**
+ * @brief Formats a move as the short command that performs it.
+ * @param move Move to format.
+ * @return Command text accepted by ConsoleUi::handleCommand.
+ */
+static std::string moveToCommand(const Move& move) {
+    switch (move.type) {
+    case MoveType::Draw:            return "d";
+    case MoveType::Recycle:         return "przetasuj";
+    case MoveType::ColumnToColumn:  return "p " + std::to_string(move.from + 1) + " " + std::to_string(move.to + 1) + " " + std::to_string(move.count);
+    case MoveType::PileToColumn:    return "pk " + std::to_string(move.to + 1);
+    case MoveType::PileToReserve:   return "pr " + std::to_string(move.to + 1);
+    case MoveType::ColumnToReserve: return "kr " + std::to_string(move.from + 1) + " " + std::to_string(move.to + 1);
+    case MoveType::ReserveToColumn: return "rk " + std::to_string(move.from + 1) + " " + std::to_string(move.to + 1);
+    }
+    return "";
+}
+
+void ConsoleUi::publishScreen(bool redraw) {
+    // the write slot is owned by this thread, copying into it reuses the vectors of an older snapshot
+    ScreenState& state = screenStates.writeSlot();
+    // the game is copied only if it changed since this slot was filled, a message or typed key
+    // alone costs no copy
+    if (state.gameVersion != gameVersion) {
+        state.game = game;
+        state.gameVersion = gameVersion;
+        state.gameWon = isGameWon();
+    }
+    state.commandResult = commandResult;
+    state.inputBuffer = inputBuffer;
+    state.cardLayout = cardLayout;
+    state.keyMode = keyMode;
+    std::copy(std::begin(regionVersions), std::end(regionVersions), std::begin(state.regionVersions));
+    screenStates.publish();
+    if (redraw) renderScheduler.invalidate();
+}
+
+/**
+ * @brief Decodes UTF-8 text for the canvas.
+ * @param text UTF-8 bytes, invalid sequences become '?'.
+ * @return Wide text, one character per cell.
+ */
+static std::wstring fromUtf8(const std::string& text) {
+    std::wstring result;
+    result.reserve(text.size());
+    std::size_t i = 0;
+    while (i < text.size()) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        int length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size()) {
+            result += L'?';
+            i++;
+            continue;
+        }
+
+        uint32_t code = length == 1 ? lead : lead & (0x7F >> length);
+        for (int k = 1; k < length; k++) {
+            code = (code << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+        }
+        result += static_cast<wchar_t>(code);
+        i += length;
+    }
+    return result;
+}
+
+std::vector<std::wstring> ConsoleUi::statusLines(const ScreenState& state, int width) {
+    std::vector<std::wstring> text;
+    if (state.gameWon) {
+        text.push_back(L"Gra została wygrana czy chcesz rozpoczac nowa? Tak/Nie: ");
+    }
+    else {
+        // the analysis depends on the game only, so messages and typed keys do not repeat it
+        if (rendered.hintGameVersion != state.gameVersion) {
+            rendered.hintGameVersion = state.gameVersion;
+            rendered.hint.clear();
+            DeadEndAnalyzer::Report analysis = DeadEndAnalyzer::analyze(state.game);
+            if (analysis.verdict == DeadEndAnalyzer::Verdict::DeadEnd) {
+                rendered.hint = L"Uwaga: zaden ruch nie zmieni juz ukladu kart, gry nie da sie wygrac. Wpisz \"reset\" aby zaczac od nowa";
+            }
+            else if (analysis.verdict == DeadEndAnalyzer::Verdict::Forced) {
+                rendered.hint = L"Jedyny mozliwy ruch: " + fromUtf8(moveToCommand(analysis.forcedMove));
+            }
+        }
+        if (!rendered.hint.empty()) text.push_back(rendered.hint);
+
+        std::vector<std::string> messageLines = Split(state.commandResult, '\n');
+        for (const std::string& line : messageLines) {
+            text.push_back(fromUtf8(line));
+        }
+        text.push_back(fromUtf8((state.keyMode ? "skrot : " : "komenda : ") + state.inputBuffer));
+    }
+
+    // lines are wrapped here, a line wrapped by the terminal would shift every row under it
+    std::vector<std::wstring> lines;
+    for (const std::wstring& line : text) {
+        std::size_t start = 0;
+        do {
+            lines.push_back(line.substr(start, width));
+            start += width;
+        } while (start < line.size());
+    }
+    return lines;
+}
+
+void ConsoleUi::drawScreen() {
+    // without a new snapshot, as after a resize, the last one is drawn again
+    screenStates.acquire();
+    const ScreenState& state = screenStates.readSlot();
+
+    bool compact = useCompactLayout(state.cardLayout);
+    TerminalSize::Size size{ 0, 0 };
+    if (!TerminalSize::query(size)) size = TerminalSize::Size{ 0, 0 };
+    int boardColumns = compact ? compactBoardColumns : fullBoardColumns;
+    int width = (std::max)(boardColumns, size.columns - 1);
+    // a row stays free under the prompt, so the line break echoed after a command never scrolls
+    int maxRows = size.rows > 1 ? size.rows - 1 : (std::numeric_limits<int>::max)();
+
+    // everything in one synchronized update, so a terminal supporting it never shows a half drawn frame
+    std::wstring out = TerminalScreen::beginFrame();
+
+    // a new layout or terminal size, or output written by something else, starts from a clear screen
+    bool repaint = repaintPending.exchange(false) || !rendered.valid || compact != rendered.compact
+        || size.columns != rendered.terminalColumns || size.rows != rendered.terminalRows;
+    if (repaint) {
+        out += TerminalScreen::clearScreen;
+        canvas.reset(width, 0, BLACK_FG_GREEN_BG);
+        rendered.valid = true;
+        rendered.compact = compact;
+        rendered.terminalColumns = size.columns;
+        rendered.terminalRows = size.rows;
+        rendered.boardRows = -1;
+        rendered.lineMode = false;
+    }
+    else if (rendered.lineMode) {
+        // text echoed while the last command was typed lies after the prompt, where the canvas
+        // has blank cells, so it is erased with the background color
+        out += BoardCanvas::cursorTo(rendered.promptColumn, rendered.promptRow)
+            + (canvas.getBackground().empty() ? ColorUtil::RESET : canvas.getBackground()) + L"\x1b[K";
+    }
+
+    int rows = boardRows(state.game, compact);
+    std::vector<std::wstring> status = statusLines(state, width);
+    int statusRow = rows;
+    if (statusRow + static_cast<int>(status.size()) > maxRows) {
+        // the prompt stays visible: older message lines go first, then the prompt covers the board
+        int fitting = (std::max)(maxRows - statusRow, 1);
+        if (static_cast<int>(status.size()) > fitting) status.erase(status.begin(), status.end() - fitting);
+        statusRow = (std::max)((std::min)(statusRow, maxRows - static_cast<int>(status.size())), 0);
+    }
+    int totalRows = (std::min)((std::max)(rows, statusRow + static_cast<int>(status.size())), (std::max)(maxRows, 1));
+
+    // a board of another height moves the lines under it, and lines covering the board hide
+    // parts of regions, so then the whole canvas is drawn again; the diff still writes only changes
+    bool whole = repaint || rows != rendered.boardRows || statusRow < rows || rendered.statusRow < rendered.boardRows;
+    canvas.grow(totalRows);
+    if (whole) {
+        canvas.clear(0, 0, canvas.getColumns(), canvas.getRows());
+        drawBoardFrame(canvas, compact);
+        rendered.boardRows = rows;
+    }
+    for (int region = 0; region < boardRegionCount; region++) {
+        if (whole || state.regionVersions[region] != rendered.regionVersions[region]) {
+            drawBoardRegion(canvas, state.game, region, compact, rows);
+            rendered.regionVersions[region] = state.regionVersions[region];
+        }
+    }
+
+    if (whole || status != rendered.status || statusRow != rendered.statusRow) {
+        canvas.clear(0, statusRow, canvas.getColumns(), canvas.getRows() - statusRow);
+        for (std::size_t i = 0; i < status.size(); i++) {
+            canvas.set(0, statusRow + static_cast<int>(i), status[i]);
+        }
+        rendered.status = status;
+        rendered.statusRow = statusRow;
+    }
+
+    rendered.promptRow = (std::min)(statusRow + static_cast<int>(status.size()) - 1, canvas.getRows() - 1);
+    rendered.promptColumn = static_cast<int>(status.back().size());
+    rendered.lineMode = !state.keyMode;
+
+    out += canvas.diff();
+    out += BoardCanvas::cursorTo(rendered.promptColumn, rendered.promptRow);
+    out += TerminalScreen::endFrame();
+    writeFrame(out);
+}
+
+void ConsoleUi::drawChanges() {
+    publishScreen(false);
+    drawScreen();
+}
+
 std::string ConsoleUi::handleCommand(std::string command) {
     std::vector<std::string> splitted = Split(command, ' ');
 
@@ -379,7 +778,7 @@ std::string ConsoleUi::handleCommand(std::string command) {
         }
         case hash("przetasuj"): {
             if (!game.getDeck().isEmpty()) return "Nie można przetasować, na stosie są karty użyj \"dobierz\" aby dobrać karte";
-            game.getDeck().reShuffle(game.getPile());
+            game.recycleStock();
             return "Przetasowano";
         }
         case hash("reset"): {
@@ -401,6 +800,36 @@ std::string ConsoleUi::handleCommand(std::string command) {
             bool success = game.saveFileGame(splitted[1]);
             return success ? "Zapisano plik" : "Wystapil blad w zapisywaniu pliku";
         }
+        case hash("widok"): {
+            std::string invalidArguments = "Niepoprawne argumenty, oczekiwano widok [auto/pelny/kompaktowy]";
+            if (splitted.size() != 2) return invalidArguments;
+            if (splitted[1] == "auto") cardLayout = CardLayout::Auto;
+            else if (splitted[1] == "pelny") cardLayout = CardLayout::Full;
+            else if (splitted[1] == "kompaktowy") cardLayout = CardLayout::Compact;
+            else return invalidArguments;
+            return "Zmieniono widok kart";
+        }
+        case hash("statystyki"): {
+            FrameMeter::Stats lastFrame, total;
+            uint64_t frameCount;
+            {
+                std::lock_guard<std::mutex> lock(frameMeterMutex);
+                lastFrame = frameMeter.getLast();
+                total = frameMeter.getTotal();
+                frameCount = frameMeter.getFrames();
+            }
+            double frames = frameCount > 0 ? static_cast<double>(frameCount) : 1.0;
+            std::ostringstream out;
+            out << "Ostatnia klatka: bajty " << lastFrame.bytes << ", sekwencje " << lastFrame.escapes
+                << ", zmienione komorki " << lastFrame.cellsChanged << ", zapis " << lastFrame.flushSeconds * 1000.0 << " ms\n"
+                << "Srednio z " << frameCount << " klatek: bajty " << total.bytes / frames
+                << ", sekwencje " << total.escapes / frames << ", zmienione komorki " << total.cellsChanged / frames
+                << ", zapis " << total.flushSeconds * 1000.0 / frames << " ms";
+            return out.str();
+        }
+        case hash("klawisze"): {
+            return setKeyMode(true);
+        }
         case hash("pomoc"): {
             return "Dostepne komendy\n"
                 "wyjdz - wychodzi z gry\n"
@@ -414,45 +843,20 @@ std::string ConsoleUi::handleCommand(std::string command) {
                 "z_rezerwy_do_kolumny,rk [nr_rezerwy] [nr_kolumny] - przenosi karte z rezerwy do kolumny\n"
                 "menu - wychodzi do glownego menu\n"
                 "zapisz [nazwa zapisu] - zapisuje gre\n"
+                "widok [auto/pelny/kompaktowy] - zmienia rozmiar kart, auto dobiera go do okna\n"
+                "statystyki - pokazuje ile danych wysylaja klatki planszy\n"
+                "klawisze - wlacza ruchy pojedynczymi klawiszami, np. 35 przenosi z kolumny 3 do 5\n"
                 "pomoc - wyswietla wszystkie komendy";
         }
     }
     return "Nie znaleziono komendy";
 }
-#ifdef _WIN32
-CRITICAL_SECTION draw_cs;
-
-DWORD WINAPI ResizeWatcher(LPVOID lpParam) {
-    ConsoleUi* stdUi = reinterpret_cast<ConsoleUi*>(lpParam);
-
-    while (stdUi->running) {
-        if (stdUi->inMainMenu) {
-            Sleep(100);
-            continue;
-        }
-        EnterCriticalSection(&draw_cs);
-        if (WindowsConsole::hasResized()) {
-            WindowsConsole::clear();
-            stdUi->draw();
-            std::cout << "wpisz komende aby zagrać jeżeli nie znasz komend wpisz \"pomoc\"\n";
-            std::cout << "komenda: ";
-            std::cout << stdUi->inputBuffer;
-        }
-        LeaveCriticalSection(&draw_cs);
-        Sleep(100);
-    }
-
-    return 0;
-}
-#endif
-
-
-
 void ConsoleUi::drawMenu() {
+    // the menu writes to the console from this thread, so no board frame may be drawn meanwhile
+    renderScheduler.suspend();
     inMainMenu = true;
     int baseTick = 0;
-    WindowsConsole::WriteWStringToConsole(ColorUtil::RESET);
-    WindowsConsole::clear();
+    TileRenderer::write(ColorUtil::RESET + TerminalScreen::clearScreen);
     std::vector<std::wstring> menuText = {
         L" __        __                  __  ",
         L"|__)  /\\  /__`    |  /\\  |\\ | /__` ",
@@ -474,15 +878,8 @@ void ConsoleUi::drawMenu() {
     std::wstring resultMessage = L"";
 
     int selectedNum = -1;
-    bool shouldRun = true;
-    while (shouldRun) {
-        if (selectedNum != -1 && selectedNum != 2) break;
-        if (saturation > 0.9) pulseUp = false;
-        if (saturation < 0.5) pulseUp = true;
-        if (pulseUp) saturation += 0.01;
-        else saturation -= 0.01;
-        
-        if (baseTick > 100) baseTick = 0; // avoid overflowing issues
+
+    auto drawMenuFrame = [&]() {
         MultiLineWStringBuilder builder;
 
         for (int row = 0; row < menuText.size(); ++row) {
@@ -497,19 +894,35 @@ void ConsoleUi::drawMenu() {
             builder.set(0, row, line);
         }
 
-        WindowsConsole::setCursorPosition(0, 0);
-        WindowsConsole::WriteWStringToConsole(builder.str());
-        WindowsConsole::WriteWStringToConsole(resultMessage.c_str());
+        TileRenderer::write(TerminalScreen::beginFrame() + L"\x1b[H" + builder.str() + resultMessage);
         if (selectedNum == 2) {
             std::cout << "podaj nazwe zapisu lub wpisz \"wyjdz\" aby wybrać inną opcję : ";
         }
         std::cout << inputBuffer;
+        std::cout.flush();
+        TileRenderer::write(TerminalScreen::endFrame());
+    };
+
+    // the animation runs on a timer and keys are handled as soon as they arrive, so the menu
+    // waits in the event loop instead of sleeping between input checks
+    int animationTimer = events.addTimer(std::chrono::milliseconds(50), [&]() {
+        if (saturation > 0.9) pulseUp = false;
+        if (saturation < 0.5) pulseUp = true;
+        if (pulseUp) saturation += 0.01;
+        else saturation -= 0.01;
 
-		bool selectionMade = WindowsConsole::processConsoleInput(inputBuffer, false);
-		if (selectedNum == 2 && selectionMade) {
+        baseTick += 1;
+        if (baseTick > 100) baseTick = 0; // avoid overflowing issues
+        drawMenuFrame();
+    }, true);
+
+    // set when a selection ends the menu, lines read after it are left for the game
+    bool menuDone = false;
+    auto handleSelection = [&]() {
+		if (selectedNum == 2) {
             std::string buffer = inputBuffer;
             inputBuffer = "";
-            WindowsConsole::clear();
+            TileRenderer::write(TerminalScreen::clearScreen);
 
 			if (buffer == "wyjdz") {
 				selectedNum = -1;
@@ -529,34 +942,34 @@ void ConsoleUi::drawMenu() {
                             resultMessage = L"Wystąpił błąd w czytaniu pliku\n";
 						}
 						else {
-							shouldRun = false;
+							menuDone = true;
 						}
 					}
 				}
 			}
 
         }
-        else if (selectionMade && inputBuffer == "wyjdz") {
+        else if (inputBuffer == "wyjdz") {
             inputBuffer = "";
-            WindowsConsole::clear();
+            TileRenderer::write(TerminalScreen::clearScreen);
             running = false;
-            break;
-        } else if (selectionMade) {
+            menuDone = true;
+        } else {
 
             std::string buffer = inputBuffer;
             inputBuffer = "";
-            WindowsConsole::clear();
+            TileRenderer::write(TerminalScreen::clearScreen);
             int num;
             try {
                 num = std::stoi(buffer);
             }
             catch (...) {
                 resultMessage = L"Nie została wpisana liczba\n";
-                continue;
+                return;
             }
             if (num < 1 || num > (latestFound ? 3 : 2)) {
                 resultMessage = L"Została wpisana nieprawidłowa liczba\n";
-                continue;
+                return;
             } 
             selectedNum = num;
             if (selectedNum == 3) {
@@ -565,105 +978,316 @@ void ConsoleUi::drawMenu() {
             else if (selectedNum == 1) {
                 game.reset();
             }
+            if (selectedNum != 2) menuDone = true;
         }
-        
-        baseTick += 1;
-        Sleep(50);
-    }
-    WindowsConsole::WriteWStringToConsole(BLACK_FG_GREEN_BG);
-    inMainMenu = false;
-}
-void ConsoleUi::start() {
-  //  game.test();
+    };
+
+    events.setInputHandler([&]() {
 #ifdef _WIN32
-    WindowsConsole::enable24BitColors();
+		if (WindowsConsole::processConsoleInput(inputBuffer, false)) handleSelection();
+#else
+        // the terminal echoes typed text itself, a selection arrives as a whole line
+        bool open = EventLoop::readInput(pendingInput);
+        while (!menuDone && takeLine(pendingInput, inputBuffer)) handleSelection();
+        if (!open && !menuDone) {
+            running = false;
+            menuDone = true;
+        }
 #endif
-    try {
-        std::locale::global(std::locale("en_US.UTF-8"));
-    }
-    catch (const std::runtime_error&) {
-        std::locale::global(std::locale(""));
+        if (menuDone) events.stop();
+        else drawMenuFrame();
+    });
+
+    drawMenuFrame();
+    events.run();
+    events.cancelTimer(animationTimer);
+    setGameHandlers();
+
+    TileRenderer::write(BLACK_FG_GREEN_BG);
+    inMainMenu = false;
+    // the menu wrote over the board, so the next frame clears the screen and draws everything
+    repaintPending = true;
+    publishScreen(false);
+    renderScheduler.resume();
+}
+
+#ifndef _WIN32
+/**
+ * @brief Measures an escape sequence sent by an arrow or function key, so the key mode skips it.
+ * @param text Bytes read from standard input.
+ * @param pos Position of the byte to check.
+ * @return Length of the CSI or SS3 sequence starting at pos, 0 for a lone Esc or any other byte.
+ */
+static std::size_t escapeSequenceLength(const std::string& text, std::size_t pos) {
+    if (text[pos] != KeyChordParser::escapeKey || pos + 1 >= text.size()) return 0;
+    if (text[pos + 1] == 'O') return pos + 2 < text.size() ? 3 : 0;
+    if (text[pos + 1] != '[') return 0;
+    for (std::size_t end = pos + 2; end < text.size(); ++end) {
+        // parameters and intermediates run until a final byte in @ to ~
+        if (text[end] >= '@' && text[end] <= '~') return end - pos + 1;
     }
-    std::cout.imbue(std::locale());
+    return 0;
+}
+#endif
 
+void ConsoleUi::setGameHandlers() {
+    events.setInputHandler([this]() {
 #ifdef _WIN32
-    drawMenu();
+        if (keyMode) {
+            std::string keys;
+            WindowsConsole::readKeys(keys);
+            for (char key : keys) {
+                if (!running || !keyMode) break;
+                handleKey(key);
+            }
+            if (!running) events.stop();
+            return;
+        }
+        bool lineDone = WindowsConsole::processConsoleInput(inputBuffer, true);
+        if (!lineDone) {
+            // typed text goes into the snapshot, so a redraw after a resize keeps it
+            publishScreen(false);
+            return;
+        }
+        std::string line = inputBuffer;
+        inputBuffer.clear();
+        handleLine(line);
 #else
-    if (BufferedIO::fileExists("latest.sot")) {
-        std::cout << "zapis ostatniej gry zostal znaleziony czy chcesz go zaladowac? Tak/Nie: ";
-        std::string response = "";
-        std::cin >> response;
+        bool open = EventLoop::readInput(pendingInput);
+        std::size_t used = 0;
+        // the mode may change between two keys or lines, so each one is read in the current mode
+        while (running && used < pendingInput.size()) {
+            if (keyMode) {
+                std::size_t sequence = escapeSequenceLength(pendingInput, used);
+                if (sequence > 0) {
+                    used += sequence;
+                    continue;
+                }
+                handleKey(pendingInput[used++]);
+                continue;
+            }
 
+            std::size_t end = pendingInput.find('\n', used);
+            if (end == std::string::npos) break;
+            std::string line = pendingInput.substr(used, end - used);
+            used = end + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            handleLine(line);
+        }
+        pendingInput.erase(0, used);
+        if (!open) {
+            // a last line without a line break still counts at the end of input
+            if (running && !pendingInput.empty()) handleLine(pendingInput);
+            pendingInput.clear();
+            running = false;
+        }
+#endif
+        if (!running) events.stop();
+    });
+    events.setResizeHandler([this]() {
+        // the render thread redraws the last published state, the loop never waits for it
+        if (!inMainMenu) renderScheduler.invalidate();
+    });
+}
+
+void ConsoleUi::handleLine(const std::string& line) {
+    if (isGameWon()) {
+        std::string response = line;
         std::transform(response.begin(), response.end(), response.begin(),
             [](unsigned char c) { return std::tolower(c); });
+
         if (response == "tak") {
-            bool code = game.readFileGame("latest");
-            std::cout << "load code " << code;
-            system("pause");
+            game.reset();
+        }
+        else {
+            running = false;
+            return;
         }
     }
-#endif
-
-#ifdef _WIN32
-    InitializeCriticalSection(&draw_cs);
-    HANDLE resizeThread = CreateThread(nullptr, 0, ResizeWatcher, this, 0, nullptr);
-#endif
-   
+    else {
+        commandResult = handleCommand(line);
+        if (!running) return;
+    }
 
-    std::string commandResult = "wpisz komende aby zagrać jeżeli nie znasz komend wpisz \"pomoc\"";
+    // commands are applied here and only their result is handed over, so pasted or piped
+    // commands never wait for the terminal; the render thread draws the latest state
+    publishScreen();
+}
 
-    draw(); // draws whole background after second use of draw
-    while(running) {
-        draw:
-#ifdef _WIN32
-        EnterCriticalSection(&draw_cs);
-        WindowsConsole::clear();
-#elif
-        system("clear");
-#endif
+void ConsoleUi::handleKey(char key) {
+    // the new game question takes a single key too
+    if (isGameWon()) {
+        if (key == 't' || key == 'n') handleLine(key == 't' ? "tak" : "nie");
+        return;
+    }
 
-        draw();
+    switch (keyChords.feed(key)) {
+    case KeyChordParser::Status::Pending:
+        // only the prompt changed
+        inputBuffer = keyChords.getPending();
+        publishScreen();
+        return;
+    case KeyChordParser::Status::Invalid:
+        commandResult = "Nieznany skrot \"" + keyChords.getPending() + "\", Esc anuluje, q wraca do komend";
+        break;
+    case KeyChordParser::Status::Cancelled:
+        commandResult = "Anulowano skrot";
+        break;
+    case KeyChordParser::Status::Leave:
+        commandResult = setKeyMode(false);
+        break;
+    case KeyChordParser::Status::Complete: {
+        Move move = keyChords.getMove();
+        if (move.type == MoveType::ColumnToColumn) {
+            // a chord names only the columns, the longest run the target column takes is moved
+            move.count = 1;
+            for (const Move& legal : game.getLegalMoves()) {
+                if (legal.type == MoveType::ColumnToColumn && legal.from == move.from && legal.to == move.to) {
+                    move.count = (std::max)(move.count, legal.count);
+                }
+            }
+        }
+        // applied through the command, so messages match the typed commands
+        commandResult = handleCommand(moveToCommand(move));
+        inputBuffer.clear();
+        publishScreen();
+        return;
+    }
+    }
 
+    inputBuffer.clear();
+    publishScreen();
+}
 
-#ifdef _WIN32 
-        LeaveCriticalSection(&draw_cs);
-#endif
-        if (game.isGameWon()) {
-            std::cout << "Gra została wygrana czy chcesz rozpoczac nowa? Tak/Nie: ";
-            std::string response = "";
-            std::cin >> response;
+std::string ConsoleUi::setKeyMode(bool enabled) {
+    keyChords.clear();
+    inputBuffer.clear();
+    if (!enabled) {
+        RawInput::disable();
+        keyMode = false;
+        return "Tryb komend, wpisz \"klawisze\" aby wrocic do skrotow";
+    }
 
-            std::transform(response.begin(), response.end(), response.begin(),
-                [](unsigned char c) { return std::tolower(c); });
+    if (!RawInput::enable()) return "Nie udalo sie przelaczyc terminala na pojedyncze klawisze";
+    keyMode = true;
+    return "Tryb klawiszy: 35 z kolumny 3 do 5, p5 z puli do kolumny, pr2 z puli do rezerwy, 3r2 z kolumny do rezerwy, "
+        "r25 z rezerwy do kolumny, d dobiera, t przetasowuje, Esc anuluje, q wraca do komend";
+}
 
-            if (response == "tak") {
-                game.reset();
-                goto draw;
-            } else break;
+void ConsoleUi::onGameEvent(const GameEvent& event, void* context) {
+    ConsoleUi* ui = static_cast<ConsoleUi*>(context);
+    ui->gameVersion++;
 
+    // the render thread draws again only the regions whose version differs from its last frame
+    auto regionOf = [](CardPlace place, int index) {
+        switch (place) {
+        case CardPlace::Column:  return firstColumnRegion + index;
+        case CardPlace::Reserve: return firstReserveRegion + index;
+        default:                 return stockRegion;
         }
+    };
+    if (event.type == GameEventType::GameReset) {
+        for (uint64_t& version : ui->regionVersions) version = ui->gameVersion;
+    }
+    else {
+        ui->regionVersions[regionOf(event.from, event.fromIndex)] = ui->gameVersion;
+        ui->regionVersions[regionOf(event.to, event.toIndex)] = ui->gameVersion;
+    }
+    // the game is won by complete columns, so only a change of a column can decide it
+    if (event.from == CardPlace::Column || event.to == CardPlace::Column || event.type == GameEventType::GameReset) {
+        ui->winCheckPending = true;
+    }
+    // commands which change nothing, as failed moves or "pomoc", do not save
+    ui->scheduleAutosave();
+}
+
+bool ConsoleUi::isGameWon() {
+    if (winCheckPending) {
+        gameWon = game.isGameWon();
+        winCheckPending = false;
+    }
+    return gameWon;
+}
+
+void ConsoleUi::scheduleAutosave() {
+    // saving waits for a pause in the commands, a burst of moves is written once
+    autosavePending = true;
+    if (autosaveTimer != 0) events.cancelTimer(autosaveTimer);
+    autosaveTimer = events.addTimer(autosaveDelay, [this]() {
+        autosaveTimer = 0;
+        startAutosave();
+    });
+}
+
+void ConsoleUi::startAutosave() {
+    // a save still running is followed by another one when it completes
+    if (autosaveThread.joinable()) return;
+
+    autosavePending = false;
+    autosaveGame = game;
+    autosaveThread = std::thread([this]() {
+        bool saved = autosaveGame.saveFileGame("latest");
+        events.post([this, saved]() { finishAutosave(saved); });
+    });
+}
+
+void ConsoleUi::finishAutosave(bool saved) {
+    autosaveThread.join();
+    if (!saved) {
+        commandResult = "Nie udalo sie zapisac ostatniej gry";
+        publishScreen();
+    }
+    if (autosavePending && autosaveTimer == 0) startAutosave();
+}
+
+void ConsoleUi::flushAutosave() {
+    if (autosaveTimer != 0) {
+        events.cancelTimer(autosaveTimer);
+        autosaveTimer = 0;
+    }
+    if (autosaveThread.joinable()) autosaveThread.join();
+    if (autosavePending) {
+        autosavePending = false;
+        game.saveFileGame("latest");
+    }
+}
 
-        std::cout << commandResult << "\n";
-        std::cout << "komenda : ";
-        std::string input;
+void ConsoleUi::start() {
+  //  game.test();
 #ifdef _WIN32
-        input = WindowsConsole::getLine(true,&inputBuffer);
-#else
-        std::getline(std::cin, input);
+    WindowsConsole::enable24BitColors();
 #endif
-        commandResult = handleCommand(input);
-        game.saveFileGame("latest");
+    ColorUtil::setColorMode(ColorUtil::detectColorMode());
+    TerminalScreen::setSynchronizedOutput(TerminalScreen::detectSynchronizedOutput());
+    initColors();
+    try {
+        std::locale::global(std::locale("en_US.UTF-8"));
+    }
+    catch (const std::runtime_error&) {
+        std::locale::global(std::locale(""));
+    }
+    std::cout.imbue(std::locale());
+
+    // the game runs on the alternate screen, so it leaves no frames in the scrollback and the
+    // terminal shows what it had before once the game ends
+    TileRenderer::write(TerminalScreen::enterAlternateScreen);
+
+    commandResult = welcomeMessage;
+    drawMenu();
+
+    if (running) {
+        setGameHandlers();
+        publishScreen();
+        renderScheduler.start();
+        events.run();
     }
 
     running = false;
-    std::wcout << ColorUtil::RESET;
+    renderScheduler.stop();
+    flushAutosave();
+    RawInput::disable();
+    TileRenderer::write(ColorUtil::RESET + TerminalScreen::leaveAlternateScreen);
 #ifdef _WIN32
-    WaitForSingleObject(resizeThread, INFINITE);
-    DeleteCriticalSection(&draw_cs);
-    CloseHandle(resizeThread);
     WindowsConsole::restoreConsole();
-    WindowsConsole::clear();
-#else 
-    system("clear");
 #endif
 }
@@ -1,5 +1,15 @@
 #pragma once
 #include "../Game.hpp"
+#include "BoardCanvas.hpp"
+#include "FrameMeter.hpp"
+#include "EventLoop.hpp"
+#include "KeyChordParser.hpp"
+#include "RenderScheduler.hpp"
+#include "../util/SnapshotBuffer.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
 
 /**
  * @file ConsoleUi.hpp
@@ -12,26 +22,85 @@
  */
 class ConsoleUi {
 public:
+    /**
+     * @brief Card size used to draw the board.
+     */
+    enum class CardLayout {
+        Auto,    ///< Full cards when the terminal fits them, compact cards otherwise.
+        Full,    ///< 9x5 card boxes.
+        Compact  ///< 3-wide cards, one line each and two lines for the top card.
+    };
+
     /**
      * @brief Constructs a ConsoleUi with a reference to the game instance.
      * @param game Reference to the Game object to be rendered and interacted with.
      */
     ConsoleUi(Game& game);
 
+    /**
+     * @brief Stops the render thread before the state it reads is destroyed.
+     */
+    ~ConsoleUi();
+
     /**
      * @brief Starts the user interface loop (input and render cycle).
      */
     void start();
 
     /**
-    * @brief Draws the current state of the game to the console.
+    * @brief Draws the current state of the game to the console, on the thread owning the game.
     */
     void draw();
 
-    /// bool for checking if game is running for windows resize console thread
-    volatile bool running = true;
+    /**
+    * @brief Draws a game with the given card size.
+    * @param shown Game to draw.
+    * @param layout Card size, Auto decides by the terminal size.
+    */
+    void draw(const Game& shown, CardLayout layout);
+
+    /**
+    * @brief Draws the board with 3-wide cards, for small terminals and slow links.
+    * @param shown Game to draw.
+    */
+    void drawCompact(const Game& shown);
+
+    /**
+    * @brief Chooses the card size, as the "widok" command does.
+    * @param layout Card size to use.
+    */
+    void setCardLayout(CardLayout layout) { cardLayout = layout; }
+
+    /**
+    * @brief Gets the output measurements of the frames drawn so far.
+    *
+    * Read it only while no frame is being drawn, the "statystyki" command copies it under a lock.
+    *
+    * @return Frame meter of the board.
+    */
+    const FrameMeter& getFrameMeter() const { return frameMeter; }
+
+    /**
+    * @brief Draws what changed in the latest published screen state, with hints and the prompt.
+    *
+    * Only the board regions changed since the last frame are drawn again on a canvas kept
+    * between frames, and only the cells that differ are written. A new terminal size or card
+    * layout clears the screen and draws everything. Called on the render thread of
+    * renderScheduler only, it never touches the game itself.
+    */
+    void drawScreen();
+
+    /**
+    * @brief Publishes the game and draws the changes on the calling thread, for the benchmark.
+    *
+    * Must not be used while the render thread runs.
+    */
+    void drawChanges();
+
+    /// bool for checking if game is running, cleared to leave the event loop
+    std::atomic<bool> running{ true };
     /// bool for checking if game is displayed or main menu
-    volatile bool inMainMenu = true;
+    std::atomic<bool> inMainMenu{ true };
 
     /**
     * @brief Draws main menu of a game
@@ -40,7 +109,197 @@ public:
 
     /// Buffer for windows input method
     std::string inputBuffer;
+
+    /// Draws published screen states on its own thread, coalescing redraw requests into frames.
+    RenderScheduler renderScheduler;
 private:
+    /// Board region of the deck and the pile.
+    static const int stockRegion = 0;
+    /// Board region of the first column, the others follow.
+    static const int firstColumnRegion = 1;
+    /// Board region of the first reserve slot, the others follow.
+    static const int firstReserveRegion = firstColumnRegion + Game::columnsSize;
+    /// Number of board regions drawn separately.
+    static const int boardRegionCount = firstReserveRegion + Game::reserveSlotSize;
+
+    /**
+     * @brief Everything drawScreen shows, copied from the main thread after every change.
+     */
+    struct ScreenState {
+        Game game;                                  ///< Copy of the game.
+        uint64_t gameVersion = 0;                   ///< ConsoleUi::gameVersion the copy was taken at.
+        bool gameWon = false;                       ///< True if the copied game is won.
+        std::string commandResult;                  ///< Result message of the last command.
+        std::string inputBuffer;                    ///< Text typed at the prompt so far.
+        CardLayout cardLayout = CardLayout::Auto;   ///< Chosen card size.
+        bool keyMode = false;                       ///< True if the prompt shows a key chord.
+        uint64_t regionVersions[boardRegionCount] = {};  ///< ConsoleUi::regionVersions of the copied game.
+    };
+
+    /**
+     * @brief What the last frame drew, kept by the render thread to find what changed.
+     */
+    struct RenderedScreen {
+        bool valid = false;                              ///< False until the first frame, which clears the screen.
+        bool compact = false;                            ///< Compact layout was drawn.
+        int terminalColumns = 0;                         ///< Terminal width of the frame, 0 if unknown.
+        int terminalRows = 0;                            ///< Terminal height of the frame, 0 if unknown.
+        int boardRows = 0;                               ///< Rows of the board.
+        uint64_t regionVersions[boardRegionCount] = {};  ///< Versions of the drawn regions.
+        int statusRow = 0;                               ///< First row of the hints, messages and prompt.
+        std::vector<std::wstring> status;                ///< Drawn lines under the board.
+        bool lineMode = false;                           ///< The prompt echoed typed text itself.
+        int promptColumn = 0;                            ///< Column of the cursor after the prompt.
+        int promptRow = 0;                               ///< Row of the prompt.
+        uint64_t hintGameVersion = 0;                    ///< Game version hint was computed for.
+        std::wstring hint;                               ///< Dead end or forced move hint, empty if none.
+    };
+
+    /**
+     * @brief Installs the input and resize handlers of the game screen in the event loop.
+     */
+    void setGameHandlers();
+
+    /**
+     * @brief Handles an entered line: a command, or the answer to the new game question.
+     * @param line Entered text without the line break.
+     */
+    void handleLine(const std::string& line);
+
+    /**
+     * @brief Handles a key in the key mode: extends the chord and applies it once it names a move.
+     * @param key Typed character.
+     */
+    void handleKey(char key);
+
+    /**
+     * @brief Switches between commands entered as lines and single keystroke chords.
+     * @param enabled True for the key mode.
+     * @return Message describing the mode.
+     */
+    std::string setKeyMode(bool enabled);
+
+    /**
+     * @brief Receives the changes of the game: marks the snapshot and win check out of date and schedules autosave.
+     * @param event Change of the game.
+     * @param context The ConsoleUi subscribed to the game.
+     */
+    static void onGameEvent(const GameEvent& event, void* context);
+
+    /**
+     * @brief Checks if the game is won, scanning it again only after a change of its columns.
+     * @return True if the game is won.
+     */
+    bool isGameWon();
+
+    /**
+     * @brief Restarts the autosave delay, the game is saved once no command came for a while.
+     */
+    void scheduleAutosave();
+
+    /**
+     * @brief Saves a copy of the game on a worker thread, unless a save is still running.
+     */
+    void startAutosave();
+
+    /**
+     * @brief Completes a save on the loop thread and starts another one if the game changed meanwhile.
+     * @param saved Result of the save.
+     */
+    void finishAutosave(bool saved);
+
+    /**
+     * @brief Waits for a running save and saves unsaved changes, used when the game ends.
+     */
+    void flushAutosave();
+
+    /**
+     * @brief Copies the game and the prompt into a snapshot and hands it to the render thread.
+     * @param redraw True to draw it, false to only keep it for the next frame.
+     */
+    void publishScreen(bool redraw = true);
+
+    /// Result message of the last command, shown above the prompt.
+    std::string commandResult;
+
+    /// Waits for input, resizes, menu animation and autosave completion on the main thread.
+    EventLoop events;
+
+    /// Bytes read from standard input after the last complete line.
+    std::string pendingInput;
+
+    /// Counts the changes of the game, snapshots holding an older value copy the game again.
+    uint64_t gameVersion = 1;
+
+    /// gameVersion of the last change of every board region, set from the game events.
+    uint64_t regionVersions[boardRegionCount] = {};
+
+    /// True if a change may have decided the game since gameWon was computed.
+    bool winCheckPending = true;
+
+    /// Result of the last win check.
+    bool gameWon = false;
+
+    /// True while keys are read one by one and parsed as chords instead of lines.
+    bool keyMode = false;
+
+    /// Chord typed so far in the key mode.
+    KeyChordParser keyChords;
+
+    /// Timer of the pending autosave, 0 if none.
+    int autosaveTimer = 0;
+
+    /// True if the game changed since the last save started.
+    bool autosavePending = false;
+
+    /// Copy of the game written by the autosave thread.
+    Game autosaveGame;
+
+    /// Thread writing the autosave, joined when its completion is posted back.
+    std::thread autosaveThread;
+
+    /// Card size chosen with the "widok" command.
+    CardLayout cardLayout = CardLayout::Auto;
+
+    /// Snapshots passed from the main thread to the render thread without locks.
+    SnapshotBuffer<ScreenState> screenStates;
+
+    /// Screen kept between frames, render thread only.
+    BoardCanvas canvas;
+
+    /// What the last frame drew, render thread only.
+    RenderedScreen rendered;
+
+    /// Set when something else wrote to the screen, as the menu does, so the next frame starts over.
+    std::atomic<bool> repaintPending{ false };
+
+    /// Measures bytes, escape sequences, changed cells and write time of every board frame.
+    FrameMeter frameMeter;
+
+    /// Guards frameMeter between the render thread recording and the "statystyki" command.
+    std::mutex frameMeterMutex;
+
+    /**
+     * @brief Writes a frame to the console and measures it.
+     * @param frame Text with color codes and absolute cursor moves.
+     */
+    void writeFrame(const std::wstring& frame);
+
+    /**
+     * @brief Builds the lines under the board: the hint, the last message and the prompt.
+     * @param state Shown screen state.
+     * @param width Width the lines are wrapped at.
+     * @return Lines without color codes, the prompt last.
+     */
+    std::vector<std::wstring> statusLines(const ScreenState& state, int width);
+
+    /**
+     * @brief Decides if the board is drawn with compact cards.
+     * @param layout Chosen card size.
+     * @return True for a compact layout, chosen by layout or by the terminal size.
+     */
+    static bool useCompactLayout(CardLayout layout);
+
     /// Reference to the game instance.
     Game& game;
 
@@ -118,6 +377,17 @@ private:
      *   save_name: validated as a valid filename (alphanumeric).
      *   Returns success or failure messages.
      *
+     * - "widok"
+     *   Chooses the card size.
+     *   Syntax: widok [auto/pelny/kompaktowy]
+     *   auto switches to compact cards when the terminal is too small for full ones.
+     *   Returns confirmation message.
+     *
+     * - "statystyki"
+     *   Shows output measurements of the last frame and averages over all frames.
+     *   No arguments.
+     *   Returns the measurements.
+     *
      * - "pomoc"
      *   Displays help with available commands and usage.
      *   No arguments.
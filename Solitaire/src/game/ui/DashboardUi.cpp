@@ -0,0 +1,145 @@
+#include "DashboardUi.hpp"
+#include "TileRenderer.hpp"
+#include "../util/colorUtil.hpp"
+#include "../util/hash.hpp"
+#include "../util/terminalScreen.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#ifdef _WIN32
+#include "../util/windowsConsole.hpp"
+#endif
+
+DashboardUi::DashboardUi(const DashboardOptions& options) : options(options), nextSeed(options.firstSeed) {
+    if (this->options.tilesPerRow < 1) this->options.tilesPerRow = 1;
+    if (this->options.fps < 0) this->options.fps = 0;
+
+    tiles.reserve((std::max)(options.games, 0));
+    for (int i = 0; i < options.games; i++) {
+        tiles.push_back(Tile{ Game(), GreedyBot(evaluator, options.maxRecycles) });
+        deal(tiles.back());
+    }
+}
+
+void DashboardUi::deal(Tile& tile) {
+    tile.seed = nextSeed++;
+    tile.game.reset(tile.seed);
+    tile.bot.reset(tile.game);
+    tile.moves = 0;
+    tile.state = TileState::Playing;
+}
+
+void DashboardUi::step(DashboardReport& report) {
+    for (Tile& tile : tiles) {
+        if (tile.state != TileState::Playing) {
+            // a finished game stays on screen for a second before the next deal
+            if (--tile.holdFrames <= 0) deal(tile);
+            continue;
+        }
+
+        if (tile.moves >= options.maxMoves || !tile.bot.step(tile.game)) {
+            tile.state = TileState::Lost;
+        }
+        else {
+            tile.moves++;
+            if (tile.game.isGameWon()) tile.state = TileState::Won;
+        }
+        if (tile.state == TileState::Won) report.gamesWon++;
+        if (tile.state == TileState::Lost) report.gamesLost++;
+        if (tile.state != TileState::Playing) tile.holdFrames = (std::max)(options.fps, 1);
+    }
+}
+
+uint64_t DashboardUi::hashTile(const Tile& tile) {
+    // everything a tile shows comes from the packed game and the caption fields
+    std::string packed = tile.game.packState();
+    uint64_t tileHash = hash64(packed);
+    tileHash = (tileHash ^ tile.seed) * 0x100000001b3ULL;
+    tileHash = (tileHash ^ static_cast<uint64_t>(tile.moves)) * 0x100000001b3ULL;
+    tileHash = (tileHash ^ static_cast<uint64_t>(tile.state)) * 0x100000001b3ULL;
+    return tileHash != 0 ? tileHash : 1;
+}
+
+std::wstring DashboardUi::tileCaption(const Tile& tile, int index) {
+    const wchar_t* status = tile.state == TileState::Won ? L" wygrana"
+        : tile.state == TileState::Lost ? L" utknal" : L"";
+    return L"#" + std::to_wstring(index + 1) + L" ziarno " + std::to_wstring(tile.seed)
+        + L" ruchy " + std::to_wstring(tile.moves) + status;
+}
+
+void DashboardUi::drawFrame(DashboardReport& report) {
+    std::wstring frame;
+
+    for (std::size_t i = 0; i < tiles.size(); i++) {
+        Tile& tile = tiles[i];
+        uint64_t tileHash = hashTile(tile);
+        if (tileHash == tile.drawnHash) {
+            report.tilesSkipped++;
+            continue;
+        }
+
+        TileRenderer::CaptionStyle style = tile.state == TileState::Won ? TileRenderer::CaptionStyle::Won
+            : tile.state == TileState::Lost ? TileRenderer::CaptionStyle::Lost : TileRenderer::CaptionStyle::Normal;
+        std::vector<std::wstring> lines = TileRenderer::render(tile.game, tileCaption(tile, static_cast<int>(i)), style);
+        int row = static_cast<int>(i) / options.tilesPerRow * tileHeight;
+        int column = static_cast<int>(i) % options.tilesPerRow * tileWidth;
+        for (std::size_t line = 0; line < lines.size(); line++) {
+            frame += TileRenderer::cursorTo(row + static_cast<int>(line), column) + lines[line];
+        }
+        tile.drawnHash = tileHash;
+        report.tilesDrawn++;
+    }
+
+    int rows = (static_cast<int>(tiles.size()) + options.tilesPerRow - 1) / options.tilesPerRow;
+    frame += TileRenderer::cursorTo(rows * tileHeight, 0) + ColorUtil::RESET
+        + L"klatka " + std::to_wstring(report.frames + 1) + L"/" + std::to_wstring(options.frames)
+        + L" wygrane " + std::to_wstring(report.gamesWon) + L" przegrane " + std::to_wstring(report.gamesLost)
+        + L" przerysowane " + std::to_wstring(report.tilesDrawn) + L" pominiete " + std::to_wstring(report.tilesSkipped)
+        + L" ponad_budzet " + std::to_wstring(report.framesOverBudget) + L"\x1b[K";
+
+    TileRenderer::write(TerminalScreen::synchronized(frame), &meter);
+}
+
+DashboardReport DashboardUi::run() {
+#ifdef _WIN32
+    WindowsConsole::enable24BitColors();
+#endif
+    TileRenderer::initColors();
+    DashboardReport report{};
+    bool paced = options.fps > 0;
+    auto frameInterval = paced ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / options.fps)) : std::chrono::steady_clock::duration::zero();
+
+    // tiles are drawn on a cleared alternate screen with the cursor hidden
+    TileRenderer::write(TerminalScreen::enterAlternateScreen + TerminalScreen::clearScreen + L"\x1b[?25l");
+
+    auto start = std::chrono::steady_clock::now();
+    auto nextFrame = start;
+    for (; report.frames < options.frames; report.frames++) {
+        auto frameStart = std::chrono::steady_clock::now();
+
+        step(report);
+        drawFrame(report);
+
+        auto frameEnd = std::chrono::steady_clock::now();
+        double frameMs = std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+        report.longestFrameMs = (std::max)(report.longestFrameMs, frameMs);
+
+        if (!paced) continue;
+
+        // a late frame starts the next one at once and the schedule moves on instead of catching up
+        nextFrame += frameInterval;
+        if (frameEnd > nextFrame) {
+            report.framesOverBudget++;
+            nextFrame = frameEnd;
+        }
+        else {
+            std::this_thread::sleep_until(nextFrame);
+        }
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.output = meter.getTotal();
+
+    TileRenderer::write(ColorUtil::RESET + L"\x1b[?25h" + TerminalScreen::leaveAlternateScreen);
+    return report;
+}
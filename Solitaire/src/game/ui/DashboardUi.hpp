@@ -0,0 +1,142 @@
+#pragma once
+#include "../Game.hpp"
+#include "../solver/Evaluator.hpp"
+#include "../solver/GreedyBot.hpp"
+#include "TileRenderer.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file DashboardUi.hpp
+ * @brief Declares DashboardUi, which shows many games played by bots as small tiles in one terminal.
+ */
+
+/**
+ * @struct DashboardOptions
+ * @brief Size, speed and length of a dashboard run.
+ */
+struct DashboardOptions {
+    int games = 12;              ///< Number of tiles.
+    int tilesPerRow = 4;         ///< Tiles in one row of the grid.
+    int fps = 60;                ///< Frames per second the run aims for, 0 draws frames back to back.
+    int frames = 600;            ///< Frames to draw before the run ends.
+    unsigned int firstSeed = 0;  ///< Seed of the first deal, every new deal takes the next seed.
+    int maxMoves = 500;          ///< Moves a bot makes before its game counts as lost.
+    int maxRecycles = 3;         ///< Pile recycles a bot may use.
+};
+
+/**
+ * @struct DashboardReport
+ * @brief Renderer statistics of a finished run.
+ */
+struct DashboardReport {
+    int frames;                 ///< Frames drawn.
+    double seconds;             ///< Wall-clock time of the run.
+    uint64_t tilesDrawn;        ///< Tiles written to the terminal over all frames.
+    uint64_t tilesSkipped;      ///< Tiles left untouched because their game did not change.
+    FrameMeter::Stats output;   ///< Output of all frames.
+    int framesOverBudget;       ///< Frames which took longer than the frame interval, 0 when unpaced.
+    double longestFrameMs;      ///< Longest time spent moving and drawing in one frame.
+    int gamesWon;               ///< Finished games won by the bots.
+    int gamesLost;              ///< Finished games the bots got stuck in.
+};
+
+/**
+ * @class DashboardUi
+ * @brief Plays several games with greedy bots and draws every game as a compact tile.
+ *
+ * Tiles are drawn by TileRenderer. Every tile remembers the hash of the state it showed last; a frame renders and writes only
+ * the tiles whose hash changed, each line placed with a cursor position sequence, and sends
+ * the whole frame in one write. Frames are paced to the requested rate, so the run also measures how much of
+ * the frame budget the renderer uses.
+ */
+class DashboardUi {
+public:
+    /// Columns taken by one tile, including the gap to the next tile.
+    static const int tileWidth = TileRenderer::width + 2;
+    /// Lines taken by one tile, including the gap to the next row.
+    static const int tileHeight = TileRenderer::height + 1;
+
+    /**
+     * @brief Deals the first games.
+     * @param options Size, speed and length of the run.
+     */
+    explicit DashboardUi(const DashboardOptions& options = DashboardOptions());
+
+    DashboardUi(const DashboardUi&) = delete;
+    DashboardUi& operator=(const DashboardUi&) = delete;
+
+    /**
+     * @brief Runs the dashboard for the configured number of frames.
+     * @return Renderer statistics.
+     */
+    DashboardReport run();
+
+    /**
+     * @brief Gets the output measurements of the frames drawn so far.
+     * @return Frame meter of the dashboard.
+     */
+    const FrameMeter& getFrameMeter() const { return meter; }
+
+private:
+    /// @brief State of a tile's game.
+    enum class TileState {
+        Playing, ///< The bot is still moving.
+        Won,     ///< The game was won, shown until the next deal.
+        Lost     ///< The bot got stuck, shown until the next deal.
+    };
+
+    /**
+     * @struct Tile
+     * @brief One game on the dashboard.
+     */
+    struct Tile {
+        Game game;                           ///< Game shown on the tile.
+        GreedyBot bot;                       ///< Bot playing the game.
+        unsigned int seed = 0;               ///< Seed of the deal.
+        int moves = 0;                       ///< Moves made in the game.
+        TileState state = TileState::Playing; ///< State of the game.
+        int holdFrames = 0;                  ///< Frames left before a finished game is replaced.
+        uint64_t drawnHash = 0;              ///< Hash of the tile as last drawn, 0 if never drawn.
+    };
+
+    /**
+     * @brief Starts a new deal on a tile.
+     * @param tile Tile to deal on.
+     */
+    void deal(Tile& tile);
+
+    /**
+     * @brief Advances every tile's game by one move.
+     * @param report Run statistics, updated with finished games.
+     */
+    void step(DashboardReport& report);
+
+    /**
+     * @brief Writes the tiles which changed since they were last drawn and the status line.
+     * @param report Run statistics, updated with tile counts and shown on the status line.
+     */
+    void drawFrame(DashboardReport& report);
+
+    /**
+     * @brief Hashes everything a tile shows, without rendering it.
+     * @param tile Tile to hash.
+     * @return Non-zero hash.
+     */
+    static uint64_t hashTile(const Tile& tile);
+
+    /**
+     * @brief Gets the caption of a tile.
+     * @param tile Tile to describe.
+     * @param index Position of the tile on the dashboard.
+     * @return Tile number, seed, moves and result.
+     */
+    static std::wstring tileCaption(const Tile& tile, int index);
+
+    DashboardOptions options;    ///< Size, speed and length of the run.
+    WeightedEvaluator evaluator; ///< Evaluator shared by all bots.
+    std::vector<Tile> tiles;     ///< Games on the dashboard.
+    unsigned int nextSeed;       ///< Seed of the next deal.
+    FrameMeter meter;            ///< Measures the output of every frame.
+};
@@ -0,0 +1,215 @@
+#include "EventLoop.hpp"
+#include <algorithm>
+#ifdef _WIN32
+#include "../util/windowsConsole.hpp"
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+/// Write end of the self-pipe of the live loop, read by the signal handler.
+static volatile sig_atomic_t resizePipe = -1;
+/// SIGWINCH handler installed before the loop.
+static struct sigaction previousResizeAction;
+
+/// Byte written to the self-pipe for a resize.
+static const char resizeByte = 'r';
+/// Byte written to the self-pipe for a posted callback.
+static const char postByte = 'p';
+
+/// @brief Forwards SIGWINCH to the loop through the self-pipe, only async-signal-safe calls.
+static void onResizeSignal(int) {
+    int savedErrno = errno;
+    if (resizePipe >= 0) {
+        ssize_t ignored = write(resizePipe, &resizeByte, 1);
+        (void)ignored;
+    }
+    errno = savedErrno;
+}
+#endif
+
+EventLoop::EventLoop() {
+#ifdef _WIN32
+    wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+#else
+    int fds[2];
+    if (pipe(fds) == 0) {
+        wakeRead = fds[0];
+        wakeWrite = fds[1];
+        for (int fd : fds) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        resizePipe = wakeWrite;
+
+        struct sigaction action {};
+        action.sa_handler = onResizeSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        sigaction(SIGWINCH, &action, &previousResizeAction);
+    }
+#endif
+}
+
+EventLoop::~EventLoop() {
+#ifdef _WIN32
+    if (wakeEvent != nullptr) CloseHandle(wakeEvent);
+#else
+    if (wakeRead >= 0) {
+        sigaction(SIGWINCH, &previousResizeAction, nullptr);
+        resizePipe = -1;
+        close(wakeRead);
+        close(wakeWrite);
+    }
+#endif
+}
+
+void EventLoop::setInputHandler(Callback handler) {
+    inputHandler = std::move(handler);
+}
+
+void EventLoop::setResizeHandler(Callback handler) {
+    resizeHandler = std::move(handler);
+}
+
+int EventLoop::addTimer(std::chrono::milliseconds delay, Callback callback, bool repeat) {
+    int id = nextTimerId++;
+    timers.push_back(Timer{ id, std::chrono::steady_clock::now() + delay, delay, repeat, std::move(callback) });
+    return id;
+}
+
+void EventLoop::cancelTimer(int id) {
+    timers.erase(std::remove_if(timers.begin(), timers.end(),
+        [id](const Timer& timer) { return timer.id == id; }), timers.end());
+}
+
+void EventLoop::post(Callback callback) {
+    {
+        std::lock_guard<std::mutex> lock(postedMutex);
+        posted.push_back(std::move(callback));
+    }
+#ifdef _WIN32
+    SetEvent(wakeEvent);
+#else
+    ssize_t ignored = write(wakeWrite, &postByte, 1);
+    (void)ignored;
+#endif
+}
+
+void EventLoop::run() {
+    while (!stopRequested) {
+        dispatch();
+    }
+    stopRequested = false;
+}
+
+void EventLoop::stop() {
+    stopRequested = true;
+}
+
+#ifndef _WIN32
+bool EventLoop::readInput(std::string& text) {
+    char buffer[4096];
+    ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+    while (count < 0 && errno == EINTR) {
+        count = read(STDIN_FILENO, buffer, sizeof(buffer));
+    }
+    if (count <= 0) return false;
+    text.append(buffer, static_cast<std::size_t>(count));
+    return true;
+}
+#endif
+
+void EventLoop::dispatch() {
+    // wait until the nearest timer at most, or forever without timers
+    long long timeoutMs = -1;
+    if (!timers.empty()) {
+        auto nearest = std::min_element(timers.begin(), timers.end(),
+            [](const Timer& a, const Timer& b) { return a.due < b.due; })->due;
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(nearest - std::chrono::steady_clock::now());
+        timeoutMs = (std::max<long long>)(wait.count(), 0);
+    }
+
+#ifdef _WIN32
+    HANDLE handles[2] = { wakeEvent, WindowsConsole::stdIn };
+    DWORD count = inputHandler ? 2 : 1;
+    DWORD result = WaitForMultipleObjects(count, handles, FALSE, timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+
+    if (result == WAIT_OBJECT_0) {
+        runPosted();
+    }
+    else if (result == WAIT_OBJECT_0 + 1) {
+        // handlers run from copies, as a handler may replace itself
+        Callback input = inputHandler;
+        input();
+        // window size events arrive with the input, the handler reads them along with the keys
+        Callback resize = resizeHandler;
+        if (WindowsConsole::hasResized() && resize) resize();
+    }
+#else
+    pollfd fds[2] = { { wakeRead, POLLIN, 0 }, { STDIN_FILENO, POLLIN, 0 } };
+    nfds_t count = inputHandler ? 2 : 1;
+    int ready = poll(fds, count, static_cast<int>(timeoutMs));
+
+    if (ready > 0) {
+        if (fds[0].revents & POLLIN) {
+            bool resized = false;
+            char bytes[64];
+            ssize_t bytesRead;
+            while ((bytesRead = read(wakeRead, bytes, sizeof(bytes))) > 0) {
+                resized = resized || std::find(bytes, bytes + bytesRead, resizeByte) != bytes + bytesRead;
+            }
+            runPosted();
+            // handlers run from copies, as a handler may replace itself
+            Callback resize = resizeHandler;
+            if (resized && resize) resize();
+        }
+        // end of input reports POLLHUP without POLLIN on some systems, the handler sees it as a 0 read
+        Callback input = inputHandler;
+        if (count > 1 && (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) && input) {
+            input();
+        }
+    }
+#endif
+
+    runTimers();
+}
+
+void EventLoop::runTimers() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<int> due;
+    for (const Timer& timer : timers) {
+        if (timer.due <= now) due.push_back(timer.id);
+    }
+
+    // timers are looked up again before every call, a callback may cancel or add timers
+    for (int id : due) {
+        auto it = std::find_if(timers.begin(), timers.end(), [id](const Timer& timer) { return timer.id == id; });
+        if (it == timers.end()) continue;
+
+        Callback callback = it->callback;
+        if (it->repeat) {
+            // a late tick is not repeated, the timer keeps its rhythm from now on
+            it->due = (std::max)(it->due + it->interval, now);
+        }
+        else {
+            timers.erase(it);
+        }
+        callback();
+    }
+}
+
+void EventLoop::runPosted() {
+    std::vector<Callback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(postedMutex);
+        callbacks.swap(posted);
+    }
+    for (Callback& callback : callbacks) {
+        callback();
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file EventLoop.hpp
+ * @brief Declares EventLoop, which waits for input, resizes, timers and posted work on one thread.
+ */
+
+/**
+ * @class EventLoop
+ * @brief Single-threaded dispatcher of console input, terminal resizes, timers and posted callbacks.
+ *
+ * The loop sleeps in one blocking call until something happens: poll() on standard input and a
+ * self-pipe on Linux, WaitForMultipleObjects() on the console input handle and an event on
+ * Windows, with the timeout of the nearest timer. Resizes arrive through SIGWINCH written to the
+ * self-pipe on Linux and as console window events on Windows. Other threads hand results back
+ * with post(), which wakes the loop. Nothing polls, so an idle loop uses no CPU.
+ */
+class EventLoop {
+public:
+    /// Function called on the loop thread.
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief Creates the loop, on Linux also the self-pipe and the SIGWINCH handler.
+     *
+     * Only one loop should exist at a time, as the resize signal has a single handler.
+     */
+    EventLoop();
+
+    /**
+     * @brief Closes the wake-up handles and restores the previous SIGWINCH handler.
+     */
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Sets the function called when standard input can be read without blocking.
+     *
+     * On Linux it is also called at end of input, when reading returns 0; the handler should
+     * then remove itself or stop the loop. On Windows it is called for any console input
+     * event, which the handler must read.
+     *
+     * @param handler Input handler, nullptr to stop watching input.
+     */
+    void setInputHandler(Callback handler);
+
+    /**
+     * @brief Sets the function called after the terminal was resized.
+     * @param handler Resize handler, nullptr to ignore resizes.
+     */
+    void setResizeHandler(Callback handler);
+
+    /**
+     * @brief Adds a timer.
+     * @param delay Time until the first call, and between calls of a repeating timer.
+     * @param callback Function to call.
+     * @param repeat True to call it every delay until it is cancelled.
+     * @return Id for cancelTimer.
+     */
+    int addTimer(std::chrono::milliseconds delay, Callback callback, bool repeat = false);
+
+    /**
+     * @brief Removes a timer, ids of timers which already fired are ignored.
+     * @param id Timer id.
+     */
+    void cancelTimer(int id);
+
+    /**
+     * @brief Runs a function on the loop thread. Safe to call from any thread.
+     * @param callback Function to run.
+     */
+    void post(Callback callback);
+
+    /**
+     * @brief Dispatches events until stop() is called.
+     *
+     * May be called again from a handler; stop() then ends the innermost run only.
+     */
+    void run();
+
+    /**
+     * @brief Makes the innermost run() return after the current handler.
+     */
+    void stop();
+
+#ifndef _WIN32
+    /**
+     * @brief Reads the bytes standard input has ready, to be called from the input handler.
+     * @param text Receives the bytes appended.
+     * @return False at end of input or on a read error.
+     */
+    static bool readInput(std::string& text);
+#endif
+
+private:
+    /**
+     * @brief A pending timer.
+     */
+    struct Timer {
+        int id;                                      ///< Id returned by addTimer.
+        std::chrono::steady_clock::time_point due;   ///< Next call.
+        std::chrono::milliseconds interval;          ///< Delay between calls.
+        bool repeat;                                 ///< True for a repeating timer.
+        Callback callback;                           ///< Function to call.
+    };
+
+    /**
+     * @brief Waits for the next events and dispatches them.
+     */
+    void dispatch();
+
+    /**
+     * @brief Calls the timers that are due.
+     */
+    void runTimers();
+
+    /**
+     * @brief Runs the callbacks posted by other threads.
+     */
+    void runPosted();
+
+    Callback inputHandler;              ///< Called when input is ready.
+    Callback resizeHandler;             ///< Called after a resize.
+    std::vector<Timer> timers;          ///< Pending timers.
+    int nextTimerId = 1;                ///< Id of the next timer.
+    bool stopRequested = false;         ///< Set by stop(), cleared when run() returns.
+
+    std::mutex postedMutex;             ///< Guards posted.
+    std::vector<Callback> posted;       ///< Callbacks posted by other threads.
+
+#ifdef _WIN32
+    void* wakeEvent = nullptr;          ///< Event HANDLE signalled by post().
+#else
+    int wakeRead = -1;                  ///< Read end of the self-pipe.
+    int wakeWrite = -1;                 ///< Write end of the self-pipe, also used by the signal handler.
+#endif
+};
@@ -0,0 +1,211 @@
+#include "FrameMeter.hpp"
+#include <algorithm>
+#include <sstream>
+
+/// @brief Splits control sequence parameters, empty parameters become 0.
+static std::vector<int> splitParameters(const std::wstring& parameters) {
+    std::vector<int> values;
+    int value = 0;
+    bool any = false;
+    for (wchar_t ch : parameters) {
+        if (ch == L';') {
+            values.push_back(value);
+            value = 0;
+            any = false;
+        }
+        else if (ch >= L'0' && ch <= L'9') {
+            value = value * 10 + (ch - L'0');
+            any = true;
+        }
+    }
+    if (any || !values.empty() || parameters.empty()) values.push_back(value);
+    return values;
+}
+
+uint64_t FrameMeter::utf8Length(const std::wstring& text) {
+    uint64_t length = 0;
+    for (wchar_t wch : text) {
+        uint32_t code = static_cast<uint32_t>(wch);
+        length += code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4;
+    }
+    return length;
+}
+
+void FrameMeter::record(const std::wstring& frame, double flushSeconds) {
+    last = Stats();
+    last.bytes = utf8Length(frame);
+    last.flushSeconds = flushSeconds;
+
+    std::size_t i = 0;
+    while (i < frame.size()) {
+        wchar_t ch = frame[i];
+        if (ch == L'\x1b') {
+            last.escapes++;
+            if (i + 1 < frame.size() && frame[i + 1] == L'[') {
+                // parameters and intermediates up to the final character
+                std::size_t end = i + 2;
+                while (end < frame.size() && (frame[end] < 0x40 || frame[end] > 0x7E)) end++;
+                if (end >= frame.size()) break;
+
+                std::wstring parameters = frame.substr(i + 2, end - i - 2);
+                if (frame[end] == L'm') applySgr(parameters);
+                else applyControl(parameters, frame[end]);
+                i = end + 1;
+            }
+            else {
+                i += 2;
+            }
+            continue;
+        }
+
+        if (ch == L'\n') {
+            row++;
+            column = 0;
+        }
+        else if (ch == L'\r') {
+            column = 0;
+        }
+        else if (ch == L'\b') {
+            column = std::max(column - 1, 0);
+        }
+        else if (ch >= 0x20) {
+            setCell(row, column++, Cell{ ch, style });
+        }
+        i++;
+    }
+
+    frames++;
+    total.bytes += last.bytes;
+    total.escapes += last.escapes;
+    total.cellsChanged += last.cellsChanged;
+    total.flushSeconds += last.flushSeconds;
+}
+
+void FrameMeter::applySgr(const std::wstring& parameters) {
+    std::vector<int> values = splitParameters(parameters);
+    for (std::size_t k = 0; k < values.size(); k++) {
+        int value = values[k];
+        if (value == 0) {
+            foreground.clear();
+            background.clear();
+            attributes.clear();
+        }
+        else if ((value == 38 || value == 48) && k + 1 < values.size()) {
+            // extended colors take 2 more parameters for a palette index and 4 for RGB
+            std::size_t count = values[k + 1] == 5 ? 3 : 5;
+            std::wstring color;
+            for (std::size_t c = k; c < std::min(k + count, values.size()); c++) {
+                color += std::to_wstring(values[c]) + L";";
+            }
+            (value == 38 ? foreground : background) = color;
+            k += count - 1;
+        }
+        else if ((value >= 30 && value <= 37) || (value >= 90 && value <= 97)) {
+            foreground = std::to_wstring(value);
+        }
+        else if ((value >= 40 && value <= 47) || (value >= 100 && value <= 107)) {
+            background = std::to_wstring(value);
+        }
+        else if (value == 39) {
+            foreground.clear();
+        }
+        else if (value == 49) {
+            background.clear();
+        }
+        else {
+            std::wstring attribute = std::to_wstring(value) + L";";
+            if (attributes.find(attribute) == std::wstring::npos) attributes += attribute;
+        }
+    }
+    style = currentStyle();
+}
+
+void FrameMeter::applyControl(const std::wstring& parameters, wchar_t command) {
+    std::vector<int> values = splitParameters(parameters);
+    int first = values[0];
+
+    switch (command) {
+    case L'H':
+    case L'f':
+        row = std::max(first, 1) - 1;
+        column = std::max(values.size() > 1 ? values[1] : 1, 1) - 1;
+        break;
+    case L'A': row = std::max(row - std::max(first, 1), 0); break;
+    case L'B': row += std::max(first, 1); break;
+    case L'C': column += std::max(first, 1); break;
+    case L'D': column = std::max(column - std::max(first, 1), 0); break;
+    case L'J':
+        if (first == 2 || first == 3) {
+            for (std::size_t r = 0; r < screen.size(); r++) {
+                for (std::size_t c = 0; c < screen[r].size(); c++) setCell(static_cast<int>(r), static_cast<int>(c), Cell());
+            }
+        }
+        else if (first == 0) {
+            for (std::size_t r = row; r < screen.size(); r++) {
+                std::size_t start = static_cast<int>(r) == row ? column : 0;
+                for (std::size_t c = start; c < screen[r].size(); c++) setCell(static_cast<int>(r), static_cast<int>(c), Cell());
+            }
+        }
+        break;
+    case L'K':
+        if (static_cast<std::size_t>(row) < screen.size()) {
+            std::size_t start = first == 2 ? 0 : column;
+            std::size_t end = first == 1 ? std::min<std::size_t>(column + 1, screen[row].size()) : screen[row].size();
+            for (std::size_t c = start; c < end; c++) setCell(row, static_cast<int>(c), Cell());
+        }
+        break;
+    default:
+        // modes such as cursor visibility do not change cells
+        break;
+    }
+}
+
+void FrameMeter::setCell(int cellRow, int cellColumn, const Cell& cell) {
+    if (static_cast<std::size_t>(cellRow) >= screen.size()) {
+        if (cell.character == L' ' && cell.style == 0) return;
+        screen.resize(cellRow + 1);
+    }
+    std::vector<Cell>& line = screen[cellRow];
+    if (static_cast<std::size_t>(cellColumn) >= line.size()) {
+        if (cell.character == L' ' && cell.style == 0) return;
+        line.resize(cellColumn + 1);
+    }
+
+    Cell& current = line[cellColumn];
+    if (current.character != cell.character || current.style != cell.style) {
+        current = cell;
+        last.cellsChanged++;
+    }
+}
+
+uint32_t FrameMeter::currentStyle() {
+    if (foreground.empty() && background.empty() && attributes.empty()) return 0;
+
+    std::wstring key = foreground + L"|" + background + L"|" + attributes;
+    auto found = styles.find(key);
+    if (found != styles.end()) return found->second;
+
+    uint32_t id = static_cast<uint32_t>(styles.size()) + 1;
+    styles.emplace(key, id);
+    return id;
+}
+
+std::string FrameMeter::toJson() const {
+    double count = frames > 0 ? static_cast<double>(frames) : 1.0;
+    std::ostringstream out;
+    out << "{\"frames\":" << frames
+        << ",\"bytes\":" << total.bytes
+        << ",\"escapes\":" << total.escapes
+        << ",\"cells_changed\":" << total.cellsChanged
+        << ",\"flush_ms\":" << total.flushSeconds * 1000.0
+        << ",\"per_frame\":{\"bytes\":" << total.bytes / count
+        << ",\"escapes\":" << total.escapes / count
+        << ",\"cells_changed\":" << total.cellsChanged / count
+        << ",\"flush_ms\":" << total.flushSeconds * 1000.0 / count
+        << "},\"last\":{\"bytes\":" << last.bytes
+        << ",\"escapes\":" << last.escapes
+        << ",\"cells_changed\":" << last.cellsChanged
+        << ",\"flush_ms\":" << last.flushSeconds * 1000.0
+        << "}}";
+    return out.str();
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file FrameMeter.hpp
+ * @brief Declares FrameMeter, which measures what every frame sends to the terminal.
+ */
+
+/**
+ * @class FrameMeter
+ * @brief Counts bytes, escape sequences, changed cells and write time of frames.
+ *
+ * Frames are replayed on a small model of the screen which understands text, line breaks,
+ * SGR colors, cursor positioning and erasing. A cell counts as changed when its character or
+ * style differs from what the model showed before the frame, which is what a diff renderer
+ * would have to send. Clearing the screen by other means than escape sequences does not
+ * change the model, as the next frame usually redraws the same cells.
+ */
+class FrameMeter {
+public:
+    /**
+     * @struct Stats
+     * @brief Output measured for one frame or summed over frames.
+     */
+    struct Stats {
+        uint64_t bytes = 0;         ///< UTF-8 bytes written.
+        uint64_t escapes = 0;       ///< Escape sequences written.
+        uint64_t cellsChanged = 0;  ///< Screen cells whose character or style changed.
+        double flushSeconds = 0.0;  ///< Time spent in the write call.
+    };
+
+    /**
+     * @brief Measures a frame that was written to the terminal.
+     * @param frame Text of the frame with escape sequences.
+     * @param flushSeconds Time the write call took.
+     */
+    void record(const std::wstring& frame, double flushSeconds);
+
+    /**
+     * @brief Gets the measurements of the last frame.
+     * @return Last frame stats.
+     */
+    const Stats& getLast() const { return last; }
+
+    /**
+     * @brief Gets the measurements summed over all frames.
+     * @return Total stats.
+     */
+    const Stats& getTotal() const { return total; }
+
+    /**
+     * @brief Gets the number of recorded frames.
+     * @return Frame count.
+     */
+    uint64_t getFrames() const { return frames; }
+
+    /**
+     * @brief Formats the totals, per-frame averages and the last frame as a JSON object.
+     * @return JSON text without a trailing newline.
+     */
+    std::string toJson() const;
+
+    /**
+     * @brief Counts the bytes of a wide string encoded as UTF-8.
+     * @param text Text to measure.
+     * @return Encoded length.
+     */
+    static uint64_t utf8Length(const std::wstring& text);
+
+private:
+    /**
+     * @struct Cell
+     * @brief Character and style shown in one screen cell.
+     */
+    struct Cell {
+        wchar_t character = L' ';  ///< Shown character.
+        uint32_t style = 0;        ///< Interned style, 0 for the default.
+    };
+
+    /**
+     * @brief Applies SGR parameters to the current colors and attributes.
+     * @param parameters Parameter text between "\x1b[" and "m".
+     */
+    void applySgr(const std::wstring& parameters);
+
+    /**
+     * @brief Applies a control sequence other than SGR.
+     * @param parameters Parameter text.
+     * @param command Final character.
+     */
+    void applyControl(const std::wstring& parameters, wchar_t command);
+
+    /**
+     * @brief Writes a cell of the model, counting it if it changes.
+     * @param row Row of the cell.
+     * @param column Column of the cell.
+     * @param cell New content.
+     */
+    void setCell(int row, int column, const Cell& cell);
+
+    /**
+     * @brief Gets the id of the current colors and attributes.
+     * @return Interned style id.
+     */
+    uint32_t currentStyle();
+
+    std::vector<std::vector<Cell>> screen;          ///< Modelled screen contents.
+    int row = 0;                                    ///< Cursor row of the model.
+    int column = 0;                                 ///< Cursor column of the model.
+    std::wstring foreground;                        ///< Current foreground parameters.
+    std::wstring background;                        ///< Current background parameters.
+    std::wstring attributes;                        ///< Current other SGR parameters.
+    uint32_t style = 0;                             ///< Id of the current style.
+    std::unordered_map<std::wstring, uint32_t> styles; ///< Ids of seen styles.
+
+    Stats last;            ///< Last frame.
+    Stats total;           ///< Sum over all frames.
+    uint64_t frames = 0;   ///< Recorded frames.
+};
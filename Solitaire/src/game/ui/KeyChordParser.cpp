@@ -0,0 +1,92 @@
+#include "KeyChordParser.hpp"
+
+/// @brief Checks if a key names a column, 1 to 7.
+static bool isColumnKey(char key) {
+    return key >= '1' && key < '1' + Game::columnsSize;
+}
+
+/// @brief Checks if a key names a reserve slot, 1 to 4.
+static bool isSlotKey(char key) {
+    return key >= '1' && key < '1' + Game::reserveSlotSize;
+}
+
+/// @brief Converts a column or slot key to its index.
+static unsigned char keyIndex(char key) {
+    return static_cast<unsigned char>(key - '1');
+}
+
+KeyChordParser::Status KeyChordParser::feed(char key) {
+    if (dropPending) {
+        keys.clear();
+        dropPending = false;
+    }
+
+    if (key == escapeKey) {
+        keys.clear();
+        return Status::Cancelled;
+    }
+    if (key == '\b' || key == '\x7f') {
+        if (!keys.empty()) keys.pop_back();
+        return Status::Pending;
+    }
+    if (key == ' ' || key == '\r' || key == '\n') {
+        return Status::Pending;
+    }
+    if (key == 'q' && keys.empty()) {
+        return Status::Leave;
+    }
+
+    keys += key;
+    Status status = parse();
+    // a finished chord stays readable until the next key, which starts a new one
+    if (status != Status::Pending) dropPending = true;
+    return status;
+}
+
+void KeyChordParser::clear() {
+    keys.clear();
+    dropPending = false;
+}
+
+KeyChordParser::Status KeyChordParser::parse() {
+    const std::size_t length = keys.size();
+    const char first = keys[0];
+
+    auto complete = [this](MoveType type, unsigned char from, unsigned char to) {
+        move = Move{ type, from, to, 0 };
+        return Status::Complete;
+    };
+
+    if (first == 'd') return complete(MoveType::Draw, 0, 0);
+    if (first == 't') return complete(MoveType::Recycle, 0, 0);
+
+    if (first == 'p') {
+        if (length == 1) return Status::Pending;
+        if (isColumnKey(keys[1])) return complete(MoveType::PileToColumn, 0, keyIndex(keys[1]));
+        if (keys[1] != 'r') return Status::Invalid;
+        if (length == 2) return Status::Pending;
+        if (isSlotKey(keys[2])) return complete(MoveType::PileToReserve, 0, keyIndex(keys[2]));
+        return Status::Invalid;
+    }
+
+    if (first == 'r') {
+        if (length == 1) return Status::Pending;
+        if (!isSlotKey(keys[1])) return Status::Invalid;
+        if (length == 2) return Status::Pending;
+        if (isColumnKey(keys[2])) return complete(MoveType::ReserveToColumn, keyIndex(keys[1]), keyIndex(keys[2]));
+        return Status::Invalid;
+    }
+
+    if (isColumnKey(first)) {
+        if (length == 1) return Status::Pending;
+        if (isColumnKey(keys[1]) && keys[1] != first) {
+            return complete(MoveType::ColumnToColumn, keyIndex(first), keyIndex(keys[1]));
+        }
+        if (keys[1] != 'r') return Status::Invalid;
+        if (length == 2) return Status::Pending;
+        if (isSlotKey(keys[2])) return complete(MoveType::ColumnToReserve, keyIndex(first), keyIndex(keys[2]));
+        return Status::Invalid;
+    }
+
+    return Status::Invalid;
+}
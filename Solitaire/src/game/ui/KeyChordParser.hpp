@@ -0,0 +1,73 @@
+#pragma once
+#include "../Game.hpp"
+#include <string>
+
+/**
+ * @file KeyChordParser.hpp
+ * @brief Declares KeyChordParser, which turns single keystrokes into moves as they arrive.
+ */
+
+/**
+ * @class KeyChordParser
+ * @brief Parses short key chords into moves one key at a time, without waiting for Enter.
+ *
+ * Columns are the keys 1-7 and reserve slots 1-4. A chord ends as soon as it names a whole move:
+ * - "35" moves cards from column 3 to column 5 (the number of cards is left to the caller),
+ * - "p5" moves the pile card to column 5, "pr2" to reserve slot 2,
+ * - "3r2" moves the top card of column 3 to reserve slot 2, "r25" reserve slot 2 to column 5,
+ * - "d" draws a card and "t" recycles the pile into the deck.
+ *
+ * Spaces are ignored, so "3 5" works too. Backspace takes back the last key, Esc drops the
+ * chord and "q" at the start of a chord asks to leave the key mode.
+ */
+class KeyChordParser {
+public:
+    /**
+     * @brief State of the parser after a key.
+     */
+    enum class Status {
+        Pending,    ///< The chord is not finished yet, getPending shows it.
+        Complete,   ///< The chord named a move, getMove returns it.
+        Invalid,    ///< The key does not fit the chord, which was dropped.
+        Cancelled,  ///< Esc dropped the chord.
+        Leave       ///< "q" asked to leave the key mode.
+    };
+
+    /// Escape key.
+    static const char escapeKey = '\x1b';
+
+    /**
+     * @brief Adds a key to the chord.
+     * @param key Typed character.
+     * @return Status of the chord after the key.
+     */
+    Status feed(char key);
+
+    /**
+     * @brief Gets the move of the chord completed by the last feed.
+     * @return Move, with count 0 for a column to column move.
+     */
+    const Move& getMove() const { return move; }
+
+    /**
+     * @brief Gets the keys of the unfinished chord, or of the dropped one after Invalid.
+     * @return Keys typed so far.
+     */
+    const std::string& getPending() const { return keys; }
+
+    /**
+     * @brief Drops the unfinished chord.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Checks the keys typed so far and finishes the chord when it names a move.
+     * @return Status of the chord.
+     */
+    Status parse();
+
+    std::string keys;   ///< Keys of the chord, without spaces.
+    Move move{};        ///< Move of the last completed chord.
+    bool dropPending = false;   ///< True if keys hold a finished or dropped chord, cleared on the next key.
+};
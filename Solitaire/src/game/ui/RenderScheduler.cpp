@@ -0,0 +1,66 @@
+#include "RenderScheduler.hpp"
+
+RenderScheduler::RenderScheduler(RenderFunction render, std::chrono::steady_clock::duration frameInterval)
+    : renderFunction(std::move(render)), frameInterval(frameInterval),
+    lastFrame(std::chrono::steady_clock::now() - frameInterval) {}
+
+RenderScheduler::~RenderScheduler() {
+    stop();
+}
+
+void RenderScheduler::start() {
+    if (thread.joinable()) return;
+    stopping = false;
+    thread = std::thread(&RenderScheduler::run, this);
+}
+
+void RenderScheduler::stop() {
+    if (!thread.joinable()) return;
+    stopping = true;
+    dirty = true;
+    dirty.notify_one();
+    thread.join();
+}
+
+void RenderScheduler::invalidate() {
+    requests++;
+    dirty = true;
+    dirty.notify_one();
+}
+
+void RenderScheduler::suspend() {
+    suspended = true;
+    // a frame holds the mutex while drawing, so taking it waits for the frame to end
+    std::lock_guard<std::mutex> lock(frameMutex);
+}
+
+void RenderScheduler::resume() {
+    suspended = false;
+    invalidate();
+}
+
+bool RenderScheduler::isDirty() const {
+    return dirty;
+}
+
+void RenderScheduler::run() {
+    while (true) {
+        dirty.wait(false);
+        if (stopping) break;
+
+        // changes made while waiting out the interval are drawn by the same frame
+        std::this_thread::sleep_until(lastFrame + frameInterval);
+
+        std::lock_guard<std::mutex> lock(frameMutex);
+        // cleared before drawing, so a change made during the frame keeps the screen dirty;
+        // stopping is read after the clear, since stop() sets it before it sets dirty
+        dirty = false;
+        if (stopping) break;
+        // while suspended the request is dropped and resume() asks for a new frame
+        if (suspended) continue;
+
+        lastFrame = std::chrono::steady_clock::now();
+        frames++;
+        renderFunction();
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file RenderScheduler.hpp
+ * @brief Declares RenderScheduler, which draws frames on its own thread and coalesces redraw requests.
+ */
+
+/**
+ * @class RenderScheduler
+ * @brief Draws the screen on a dedicated thread at most once per frame interval.
+ *
+ * Changes only call invalidate(), which never blocks; the render thread wakes up, waits out the
+ * rest of the frame interval and draws the latest state, so any number of changes between two
+ * frames costs one draw. The render function must only read state handed over to the render
+ * thread, such as a SnapshotBuffer, never state the other threads keep changing.
+ */
+class RenderScheduler {
+public:
+    /// Function drawing the whole screen, called on the render thread.
+    using RenderFunction = std::function<void()>;
+
+    /**
+     * @brief Creates a scheduler, the render thread starts with start().
+     * @param render Function drawing the whole screen.
+     * @param frameInterval Shortest time between the starts of two frames.
+     */
+    explicit RenderScheduler(RenderFunction render,
+        std::chrono::steady_clock::duration frameInterval = std::chrono::milliseconds(16));
+
+    /**
+     * @brief Stops the render thread.
+     */
+    ~RenderScheduler();
+
+    RenderScheduler(const RenderScheduler&) = delete;
+    RenderScheduler& operator=(const RenderScheduler&) = delete;
+
+    /**
+     * @brief Starts the render thread, which draws a frame at once if the screen is dirty.
+     */
+    void start();
+
+    /**
+     * @brief Stops the render thread after the frame it is drawing, pending changes are not drawn.
+     */
+    void stop();
+
+    /**
+     * @brief Marks the screen as out of date and wakes the render thread. Never blocks.
+     */
+    void invalidate();
+
+    /**
+     * @brief Waits for the frame being drawn and keeps the render thread from drawing more.
+     *
+     * Lets another thread write to the terminal, as the main menu does. The only call that may
+     * wait for terminal output.
+     */
+    void suspend();
+
+    /**
+     * @brief Lets the render thread draw again and redraws the screen.
+     */
+    void resume();
+
+    /**
+     * @brief Checks if a change has not been drawn yet.
+     * @return True if the screen is out of date.
+     */
+    bool isDirty() const;
+
+    /**
+     * @brief Gets the number of invalidate calls.
+     * @return Redraw requests so far.
+     */
+    uint64_t getRequestCount() const { return requests; }
+
+    /**
+     * @brief Gets the number of frames drawn.
+     * @return Frames so far.
+     */
+    uint64_t getFrameCount() const { return frames; }
+
+private:
+    /**
+     * @brief Body of the render thread.
+     */
+    void run();
+
+    RenderFunction renderFunction;                        ///< Function drawing the screen.
+    std::chrono::steady_clock::duration frameInterval;    ///< Shortest time between two frames.
+    std::chrono::steady_clock::time_point lastFrame;      ///< Start of the last frame, render thread only.
+    std::atomic<bool> dirty{ false };                     ///< Set by invalidate, cleared by a frame.
+    std::atomic<bool> stopping{ false };                  ///< Asks the render thread to end.
+    std::atomic<bool> suspended{ false };                 ///< Keeps the render thread from drawing.
+    std::atomic<uint64_t> requests{ 0 };                  ///< Redraw requests.
+    std::atomic<uint64_t> frames{ 0 };                    ///< Frames drawn.
+    std::mutex frameMutex;                                ///< Held while a frame is drawn, taken by suspend.
+    std::thread thread;                                   ///< Render thread.
+};
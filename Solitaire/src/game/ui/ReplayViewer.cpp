@@ -0,0 +1,103 @@
+#include "ReplayViewer.hpp"
+#include "TileRenderer.hpp"
+#include "../util/colorUtil.hpp"
+#include "../util/terminalScreen.hpp"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#ifdef _WIN32
+#include "../util/windowsConsole.hpp"
+#endif
+
+ReplayViewer::ReplayViewer(const ReplayOptions& options) : options(options) {
+    if (this->options.fps < 1) this->options.fps = 1;
+    if (this->options.movesPerSecond <= 0.0) this->options.movesPerSecond = 1.0;
+}
+
+void ReplayViewer::draw(const Game& game, std::size_t applied, std::size_t total) {
+    std::wostringstream caption;
+    caption << L"ruch " << applied << L"/" << total << L" predkosc ";
+    if (options.speed > 0.0) caption << options.speed << L"x";
+    else caption << L"max";
+
+    std::vector<std::wstring> lines = TileRenderer::render(game, caption.str(),
+        game.isGameWon() ? TileRenderer::CaptionStyle::Won : TileRenderer::CaptionStyle::Normal);
+    std::wstring frame;
+    for (std::size_t line = 0; line < lines.size(); line++) {
+        frame += TileRenderer::cursorTo(static_cast<int>(line), 0) + lines[line];
+    }
+    TileRenderer::write(TerminalScreen::synchronized(frame), &meter);
+}
+
+ReplayReport ReplayViewer::play(unsigned int seed, const std::vector<Move>& moves) {
+    using Clock = std::chrono::steady_clock;
+#ifdef _WIN32
+    WindowsConsole::enable24BitColors();
+#endif
+    TileRenderer::initColors();
+    ReplayReport report{};
+    Game game;
+    game.reset(seed);
+
+    bool unlimited = options.speed <= 0.0;
+    double movesPerSecond = options.movesPerSecond * options.speed;
+    Clock::duration frameInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.fps));
+
+    TileRenderer::write(TerminalScreen::enterAlternateScreen + TerminalScreen::clearScreen + L"\x1b[?25l");
+    auto start = Clock::now();
+    auto nextFrame = start;
+    std::size_t drawnAt = 0;
+    bool drawn = false;
+
+    while (true) {
+        auto now = Clock::now();
+        bool finished = report.movesApplied == moves.size() || report.illegalMove;
+        bool changed = !drawn || report.movesApplied != drawnAt;
+
+        if (finished || (changed && now >= nextFrame)) {
+            if (drawn && report.movesApplied > drawnAt) report.positionsSkipped += report.movesApplied - drawnAt - 1;
+            draw(game, report.movesApplied, moves.size());
+            report.framesDrawn++;
+            drawnAt = report.movesApplied;
+            drawn = true;
+
+            // a slow terminal gets at most half of the time, the rest stays with the moves
+            auto drawEnd = Clock::now();
+            report.drawSeconds += std::chrono::duration<double>(drawEnd - now).count();
+            nextFrame = now + (std::max)(frameInterval, 2 * (drawEnd - now));
+            if (finished) break;
+            continue;
+        }
+
+        // moves whose time has come, the first move is due one move interval after the start
+        std::size_t due = moves.size();
+        if (!unlimited) {
+            double elapsed = std::chrono::duration<double>(now - start).count();
+            due = (std::min)(moves.size(), static_cast<std::size_t>(elapsed * movesPerSecond));
+        }
+
+        if (due <= report.movesApplied) {
+            auto nextMove = start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>((report.movesApplied + 1) / movesPerSecond));
+            std::this_thread::sleep_until(changed ? (std::min)(nextMove, nextFrame) : nextMove);
+            continue;
+        }
+
+        // every due move is applied, stopping only when a frame is due
+        while (report.movesApplied < due) {
+            if (!game.applyMove(moves[report.movesApplied])) {
+                report.illegalMove = true;
+                break;
+            }
+            report.movesApplied++;
+            if (Clock::now() >= nextFrame) break;
+        }
+    }
+
+    report.won = game.isGameWon();
+    report.output = meter.getTotal();
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    TileRenderer::write(ColorUtil::RESET + L"\x1b[?25h" + TerminalScreen::leaveAlternateScreen);
+    return report;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "../Game.hpp"
+#include "FrameMeter.hpp"
+#include <vector>
+
+/**
+ * @file ReplayViewer.hpp
+ * @brief Declares ReplayViewer, which plays a recorded move list back at a chosen speed.
+ */
+
+/**
+ * @struct ReplayOptions
+ * @brief Playback speed and frame rate of a replay.
+ */
+struct ReplayOptions {
+    double speed = 1.0;          ///< Speed multiplier, 0 or less plays as fast as the engine allows.
+    double movesPerSecond = 4.0; ///< Moves shown per second at speed 1.
+    int fps = 60;                ///< Most frames drawn per second.
+};
+
+/**
+ * @struct ReplayReport
+ * @brief Outcome and statistics of a replay.
+ */
+struct ReplayReport {
+    std::size_t movesApplied;   ///< Moves applied to the game.
+    bool illegalMove;           ///< True if the replay stopped at a move the game rejected.
+    bool won;                   ///< True if the last position is won.
+    int framesDrawn;            ///< Frames written to the terminal.
+    std::size_t positionsSkipped; ///< Positions applied but never drawn.
+    double seconds;             ///< Wall-clock time of the replay.
+    double drawSeconds;         ///< Time spent rendering and writing frames.
+    FrameMeter::Stats output;   ///< Output of all frames.
+};
+
+/**
+ * @class ReplayViewer
+ * @brief Applies recorded moves to a seeded deal and shows the board with TileRenderer.
+ *
+ * Moves follow their schedule (movesPerSecond times speed) and every move is always applied,
+ * but at most one frame is drawn per frame interval and a frame is only started once the
+ * previous one was written. When the terminal is slower than the moves, the positions in
+ * between are never drawn, so playback time depends on the engine rather than on output.
+ */
+class ReplayViewer {
+public:
+    /**
+     * @brief Creates a viewer.
+     * @param options Playback speed and frame rate.
+     */
+    explicit ReplayViewer(const ReplayOptions& options = ReplayOptions());
+
+    /**
+     * @brief Replays moves from a seeded deal.
+     * @param seed Seed of the deal.
+     * @param moves Recorded moves.
+     * @return Outcome and statistics.
+     */
+    ReplayReport play(unsigned int seed, const std::vector<Move>& moves);
+
+private:
+    /**
+     * @brief Draws the current position.
+     * @param game Game being replayed.
+     * @param applied Moves applied so far.
+     * @param total Moves in the replay.
+     */
+    void draw(const Game& game, std::size_t applied, std::size_t total);
+
+    ReplayOptions options; ///< Playback speed and frame rate.
+    FrameMeter meter;      ///< Measures the output of every frame.
+};
@@ -0,0 +1,161 @@
+#include "TileRenderer.hpp"
+#include "../util/colorUtil.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#ifdef _WIN32
+#include "../util/windowsConsole.hpp"
+#endif
+
+/// Color of red suits.
+static std::wstring RED_CARD;
+/// Color of black suits, light so it stays visible on dark terminals.
+static std::wstring BLACK_CARD;
+/// Color of face-down cards and empty places.
+static std::wstring HIDDEN_CARD;
+/// Color of captions.
+static std::wstring CAPTION;
+/// Color of won game captions.
+static std::wstring CAPTION_WON;
+/// Color of lost game captions.
+static std::wstring CAPTION_LOST;
+
+/**
+ * @class TileLine
+ * @brief Builds one tile line while counting visible cells, so it can be padded and cut.
+ */
+class TileLine {
+public:
+    /// @brief Appends text shown in the given color.
+    void add(const std::wstring& color, const std::wstring& text) {
+        if (cells >= TileRenderer::width) return;
+        std::wstring visible = text.substr(0, TileRenderer::width - cells);
+        if (&color != lastColor) line += color;
+        line += visible;
+        lastColor = &color;
+        cells += static_cast<int>(visible.size());
+    }
+
+    /// @brief Ends the line with a color reset and padding up to the line width.
+    std::wstring str() const {
+        return line + ColorUtil::RESET + std::wstring(TileRenderer::width - cells, L' ');
+    }
+
+private:
+    std::wstring line;  ///< Text with escape sequences.
+    int cells = 0;      ///< Visible cells in line.
+    const std::wstring* lastColor = nullptr; ///< Color set last, repeated colors are not written again.
+};
+
+/// @brief Gets the two-cell glyph of a card: rank character and suit symbol.
+static std::wstring cardGlyph(const Card& card) {
+    static const wchar_t ranks[] = L"A23456789TJQK";
+    static const wchar_t suits[] = { L'\u2665', L'\u2666', L'\u2663', L'\u2660' };
+    std::wstring glyph(1, ranks[static_cast<int>(card.getRank()) - 1]);
+    glyph += suits[static_cast<int>(card.getSuit())];
+    return glyph;
+}
+
+/// @brief Appends a face-up card to a line.
+static void addCard(TileLine& line, const Card& card) {
+    line.add(card.isRed() ? RED_CARD : BLACK_CARD, cardGlyph(card));
+}
+
+#ifndef _WIN32
+/// @brief Encodes a wide string as UTF-8 for terminals reading bytes.
+static std::string toUtf8(const std::wstring& text) {
+    std::string result;
+    result.reserve(text.size() + text.size() / 2);
+    for (wchar_t wch : text) {
+        uint32_t code = static_cast<uint32_t>(wch);
+        if (code < 0x80) {
+            result += static_cast<char>(code);
+        }
+        else if (code < 0x800) {
+            result += static_cast<char>(0xC0 | (code >> 6));
+            result += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000) {
+            result += static_cast<char>(0xE0 | (code >> 12));
+            result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            result += static_cast<char>(0xF0 | (code >> 18));
+            result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    return result;
+}
+#endif
+
+void TileRenderer::initColors() {
+    RED_CARD = ColorUtil::wrgbToForeground({ 255, 90, 90 });
+    BLACK_CARD = ColorUtil::wrgbToForeground({ 225, 225, 225 });
+    HIDDEN_CARD = ColorUtil::wrgbToForeground({ 110, 110, 110 });
+    CAPTION = ColorUtil::wrgbToForeground({ 120, 190, 255 });
+    CAPTION_WON = ColorUtil::wrgbToForeground({ 90, 220, 110 });
+    CAPTION_LOST = ColorUtil::wrgbToForeground({ 230, 160, 60 });
+}
+
+std::wstring TileRenderer::cursorTo(int row, int column) {
+    return L"\x1b[" + std::to_wstring(row + 1) + L";" + std::to_wstring(column + 1) + L"H";
+}
+
+std::vector<std::wstring> TileRenderer::render(const Game& game, const std::wstring& caption, CaptionStyle style) {
+    std::vector<std::wstring> lines;
+    lines.reserve(height);
+
+    TileLine captionLine;
+    captionLine.add(style == CaptionStyle::Won ? CAPTION_WON : style == CaptionStyle::Lost ? CAPTION_LOST : CAPTION, caption);
+    lines.push_back(captionLine.str());
+
+    TileLine piles;
+    piles.add(HIDDEN_CARD, L"talia " + std::to_wstring(game.getDeck().getCards().size()) + L" stos ");
+    if (game.getPile().empty()) piles.add(HIDDEN_CARD, L"--");
+    else addCard(piles, game.getPile().back());
+    piles.add(HIDDEN_CARD, L" rez");
+    for (int slot = 0; slot < 4; slot++) {
+        piles.add(HIDDEN_CARD, L" ");
+        const Card& card = game.getReserveSlot(slot);
+        if (card.isValid()) addCard(piles, card);
+        else piles.add(HIDDEN_CARD, L"--");
+    }
+    lines.push_back(piles.str());
+
+    for (int column = 0; column < 7; column++) {
+        TileLine line;
+        line.add(HIDDEN_CARD, std::to_wstring(column + 1) + L" ");
+        const std::vector<Card>& cards = game.getColumn(column);
+        int faceDown = 0;
+        for (const Card& card : cards) {
+            if (!card.isFacingUp()) faceDown++;
+        }
+        // the line is cut at its end, so face-down cards give way first and the top card stays visible
+        int faceUpCells = 2 * (static_cast<int>(cards.size()) - faceDown);
+        int skipped = faceDown - (width - 2 - faceUpCells);
+        for (const Card& card : cards) {
+            if (card.isFacingUp()) addCard(line, card);
+            else if (skipped > 0) skipped--;
+            else line.add(HIDDEN_CARD, L"\u2592");
+        }
+        lines.push_back(line.str());
+    }
+    return lines;
+}
+
+void TileRenderer::write(const std::wstring& text, FrameMeter* meter) {
+    auto start = std::chrono::steady_clock::now();
+#ifdef _WIN32
+    WindowsConsole::WriteWStringToConsole(text);
+#else
+    std::string bytes = toUtf8(text);
+    std::cout.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    std::cout.flush();
+#endif
+    if (meter != nullptr) {
+        meter->record(text, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+}
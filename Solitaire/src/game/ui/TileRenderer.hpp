@@ -0,0 +1,63 @@
+#pragma once
+#include "../Game.hpp"
+#include "FrameMeter.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @file TileRenderer.hpp
+ * @brief Declares the compact board renderer shared by the dashboard and the replay viewer.
+ */
+
+/**
+ * @namespace TileRenderer
+ * @brief Renders a game as a small tile of colored text and writes frames to the terminal.
+ *
+ * A tile has a caption line, a line with the deck, pile and reserve, and one line per column.
+ * Face-up cards take two cells (rank, with T for ten, and suit symbol), face-down cards one.
+ * A column too long for its line drops face-down cards from the bottom, so the top always shows.
+ */
+namespace TileRenderer {
+    /// Visible cells of every tile line, enough for a column label, six face-down cards and a King to Ace run.
+    const int width = 34;
+    /// Lines of a tile.
+    const int height = 9;
+
+    /**
+     * @brief Color of a tile caption.
+     */
+    enum class CaptionStyle {
+        Normal,  ///< Game in progress.
+        Won,     ///< Game won.
+        Lost     ///< Game lost or stopped.
+    };
+
+    /**
+     * @brief Builds the tile colors in the active color mode, must be called before rendering.
+     */
+    void initColors();
+
+    /**
+     * @brief Renders a game.
+     * @param game Game to render.
+     * @param caption Text of the first line, cut to the tile width.
+     * @param style Color of the caption.
+     * @return height lines of exactly width visible cells, with color escape sequences.
+     */
+    std::vector<std::wstring> render(const Game& game, const std::wstring& caption, CaptionStyle style = CaptionStyle::Normal);
+
+    /**
+     * @brief Gets the escape sequence placing the cursor.
+     * @param row 0-based row.
+     * @param column 0-based column.
+     * @return Cursor position sequence.
+     */
+    std::wstring cursorTo(int row, int column);
+
+    /**
+     * @brief Writes a frame to the terminal in one call.
+     * @param text Text with escape sequences.
+     * @param meter Meter recording the frame, nullptr to write without measuring.
+     */
+    void write(const std::wstring& text, FrameMeter* meter = nullptr);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file SnapshotBuffer.hpp
+ * @brief Declares SnapshotBuffer, a lock-free triple buffer handing snapshots from one thread to another.
+ */
+
+/**
+ * @class SnapshotBuffer
+ * @brief Passes the latest snapshot of some state from a writer thread to a reader thread.
+ *
+ * The writer fills its own slot and publishes it by swapping it with the shared middle slot in
+ * one atomic exchange; the reader takes the middle slot the same way. Neither side ever waits
+ * for the other, a snapshot is never seen half written, and snapshots published while the reader
+ * was busy are skipped in favour of the newest one. Slots are reused, so copying state into the
+ * write slot keeps the capacity of its containers and publishing does not allocate.
+ *
+ * @tparam T Snapshot type, must be default constructible and copy assignable.
+ */
+template <typename T>
+class SnapshotBuffer {
+public:
+    /**
+     * @brief Gets the slot the writer fills, only the writer thread may call it.
+     * @return Write slot, holding an older snapshot until it is overwritten.
+     */
+    T& writeSlot() { return slots[writeIndex]; }
+
+    /**
+     * @brief Publishes the write slot, only the writer thread may call it.
+     *
+     * The writer then gets the former middle slot to fill next.
+     */
+    void publish() {
+        writeIndex = middle.exchange(static_cast<uint8_t>(writeIndex | freshFlag), std::memory_order_acq_rel) & indexMask;
+    }
+
+    /**
+     * @brief Takes the newest published snapshot, only the reader thread may call it.
+     * @return True if a snapshot was published since the last call, readSlot then holds it.
+     */
+    bool acquire() {
+        if ((middle.load(std::memory_order_acquire) & freshFlag) == 0) return false;
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    /**
+     * @brief Gets the snapshot taken by the last successful acquire, only the reader thread may call it.
+     * @return Read slot, default constructed before the first snapshot.
+     */
+    const T& readSlot() const { return slots[readIndex]; }
+
+private:
+    static constexpr uint8_t indexMask = 0x3;  ///< Bits of the middle slot index.
+    static constexpr uint8_t freshFlag = 0x4;  ///< Set while the middle slot holds an unread snapshot.
+
+    T slots[3];                          ///< Write, middle and read slots, in changing order.
+    uint8_t writeIndex = 0;              ///< Slot owned by the writer.
+    std::atomic<uint8_t> middle{ 1 };    ///< Shared slot index and fresh flag.
+    uint8_t readIndex = 2;               ///< Slot owned by the reader.
+};
@@ -7,6 +7,8 @@
  * and text style modifiers like bold, italic, underline, etc.
  */
 #pragma once
+#include <algorithm>
+#include <cstdlib>
 #include <string>
 
 namespace ColorUtil {
@@ -47,6 +49,201 @@ namespace ColorUtil {
         int b; ///< Blue component (0-255)
     };
 
+    /**
+     * @brief Color escape sequences a terminal understands.
+     */
+    enum class ColorMode {
+        None,       ///< No colors, color sequences are left out.
+        Basic16,    ///< The 16 standard colors (SGR 30-37, 90-97 and backgrounds).
+        Palette256, ///< The xterm 256-color palette (SGR 38;5;n).
+        TrueColor   ///< 24-bit colors (SGR 38;2;r;g;b).
+    };
+
+    /// Mode used by the wide color functions below, truecolor until detection says otherwise.
+    inline ColorMode activeColorMode = ColorMode::TrueColor;
+
+    /**
+     * @brief Sets the mode used by the wide color functions.
+     *
+     * Color strings built before the call keep their encoding, so it should be called once
+     * at startup, before any color constants are built.
+     *
+     * @param mode Mode to encode colors with.
+     */
+    inline void setColorMode(ColorMode mode) {
+        activeColorMode = mode;
+    }
+
+    /**
+     * @brief Gets the mode used by the wide color functions.
+     * @return Active color mode.
+     */
+    inline ColorMode getColorMode() {
+        return activeColorMode;
+    }
+
+    /**
+     * @brief Reads an environment variable.
+     * @param name Variable name.
+     * @return Value of the variable, empty if it is not set.
+     */
+    inline std::string environmentValue(const char* name) {
+#ifdef _WIN32
+        char* buffer = nullptr;
+        std::size_t length = 0;
+        if (_dupenv_s(&buffer, &length, name) != 0 || buffer == nullptr) return "";
+        std::string value(buffer);
+        free(buffer);
+        return value;
+#else
+        const char* value = std::getenv(name);
+        return value != nullptr ? value : "";
+#endif
+    }
+
+    /**
+     * @brief Detects the colors the terminal supports from the environment.
+     *
+     * SOLITAIRE_COLOR ("truecolor", "256", "16" or "none") overrides detection, NO_COLOR turns
+     * colors off. Otherwise COLORTERM=truecolor/24bit and Windows Terminal give truecolor, and
+     * TERM gives 256 colors for *-256color, none for "dumb" and 16 colors for anything else.
+     * A Windows console without TERM supports truecolor once virtual terminal processing is on.
+     *
+     * @return Detected color mode.
+     */
+    inline ColorMode detectColorMode() {
+        std::string forced = environmentValue("SOLITAIRE_COLOR");
+        if (forced == "truecolor" || forced == "24bit") return ColorMode::TrueColor;
+        if (forced == "256") return ColorMode::Palette256;
+        if (forced == "16") return ColorMode::Basic16;
+        if (forced == "none") return ColorMode::None;
+
+        if (!environmentValue("NO_COLOR").empty()) return ColorMode::None;
+
+        std::string colorTerm = environmentValue("COLORTERM");
+        if (colorTerm == "truecolor" || colorTerm == "24bit") return ColorMode::TrueColor;
+        if (!environmentValue("WT_SESSION").empty()) return ColorMode::TrueColor;
+
+        std::string term = environmentValue("TERM");
+        if (term.empty()) {
+#ifdef _WIN32
+            return ColorMode::TrueColor;
+#else
+            return ColorMode::Basic16;
+#endif
+        }
+        if (term == "dumb") return ColorMode::None;
+        if (term.find("direct") != std::string::npos) return ColorMode::TrueColor;
+        if (term.find("256color") != std::string::npos) return ColorMode::Palette256;
+        return ColorMode::Basic16;
+    }
+
+    /**
+     * @brief Squared distance between two colors.
+     * @param a First color.
+     * @param b Second color.
+     * @return Sum of squared component differences.
+     */
+    inline int colorDistance(const RGB& a, const RGB& b) {
+        int r = a.r - b.r, g = a.g - b.g, bl = a.b - b.b;
+        return r * r + g * g + bl * bl;
+    }
+
+    /**
+     * @brief Finds the nearest color of the xterm 256-color palette.
+     *
+     * Only the 6x6x6 cube (16-231) and the gray ramp (232-255) are searched, their values are
+     * the same on every terminal, unlike the first 16 entries. Colors with a clear hue stay in
+     * the cube, the same as in rgbTo16.
+     *
+     * @param color RGB color.
+     * @return Palette index.
+     */
+    inline int rgbTo256(const RGB& color) {
+        static const int levels[6] = { 0, 95, 135, 175, 215, 255 };
+        auto nearestLevel = [](int value) {
+            int best = 0;
+            for (int i = 1; i < 6; i++) {
+                if (std::abs(levels[i] - value) < std::abs(levels[best] - value)) best = i;
+            }
+            return best;
+        };
+
+        int r = nearestLevel(color.r), g = nearestLevel(color.g), b = nearestLevel(color.b);
+        RGB cube{ levels[r], levels[g], levels[b] };
+
+        int average = (color.r + color.g + color.b) / 3;
+        int grayStep = average < 8 ? 0 : average > 238 ? 23 : (average - 8 + 5) / 10;
+        int grayValue = 8 + 10 * grayStep;
+        RGB gray{ grayValue, grayValue, grayValue };
+
+        bool chromatic = (std::max)(color.r, (std::max)(color.g, color.b)) - (std::min)(color.r, (std::min)(color.g, color.b)) >= 48;
+        if (!chromatic && colorDistance(color, gray) < colorDistance(color, cube)) return 232 + grayStep;
+        return 16 + 36 * r + 6 * g + b;
+    }
+
+    /**
+     * @brief Finds the nearest of the 16 standard colors, using the xterm default values.
+     *
+     * Colors with a clear hue are only matched against the six hues, so a muted green such as
+     * the table stays green instead of ending up the nearer gray.
+     *
+     * @param color RGB color.
+     * @return Color number, 0-7 for normal and 8-15 for bright colors.
+     */
+    inline int rgbTo16(const RGB& color) {
+        static const RGB palette[16] = {
+            { 0, 0, 0 }, { 205, 0, 0 }, { 0, 205, 0 }, { 205, 205, 0 },
+            { 0, 0, 238 }, { 205, 0, 205 }, { 0, 205, 205 }, { 229, 229, 229 },
+            { 127, 127, 127 }, { 255, 0, 0 }, { 0, 255, 0 }, { 255, 255, 0 },
+            { 92, 92, 255 }, { 255, 0, 255 }, { 0, 255, 255 }, { 255, 255, 255 }
+        };
+        int highest = (std::max)(color.r, (std::max)(color.g, color.b));
+        int lowest = (std::min)(color.r, (std::min)(color.g, color.b));
+        bool chromatic = highest - lowest >= 48;
+
+        int best = -1;
+        for (int i = 0; i < 16; i++) {
+            bool gray = i % 8 == 0 || i % 8 == 7;
+            if (chromatic && gray) continue;
+            if (best < 0 || colorDistance(color, palette[i]) < colorDistance(color, palette[best])) best = i;
+        }
+        return best;
+    }
+
+    /**
+     * @brief Builds the SGR parameters selecting a color in the active mode.
+     * @param color RGB color.
+     * @param background True for a background color, false for a foreground color.
+     * @return Parameters such as "38;2;r;g;b", "48;5;n" or "97", empty in ColorMode::None.
+     */
+    inline std::wstring colorParameters(const RGB& color, bool background) {
+        switch (activeColorMode) {
+        case ColorMode::TrueColor:
+            return (background ? L"48;2;" : L"38;2;") + std::to_wstring(color.r) + L";" +
+                std::to_wstring(color.g) + L";" + std::to_wstring(color.b);
+        case ColorMode::Palette256:
+            return (background ? L"48;5;" : L"38;5;") + std::to_wstring(rgbTo256(color));
+        case ColorMode::Basic16: {
+            int index = rgbTo16(color);
+            int base = (index < 8 ? 30 : 90) + (background ? 10 : 0);
+            return std::to_wstring(base + index % 8);
+        }
+        case ColorMode::None:
+            break;
+        }
+        return L"";
+    }
+
+    /**
+     * @brief Wraps SGR parameters in an escape sequence.
+     * @param parameters SGR parameters, may be empty.
+     * @return Escape sequence, empty for empty parameters.
+     */
+    inline std::wstring sgr(const std::wstring& parameters) {
+        return parameters.empty() ? L"" : L"\x1b[" + parameters + L"m";
+    }
+
     /**
      * @brief Converts an RGB color to an ANSI escape sequence for foreground color (std::string).
      * @param color RGB color struct
@@ -61,12 +258,10 @@ namespace ColorUtil {
     /**
      * @brief Converts an RGB color to an ANSI escape sequence for foreground color (std::wstring).
      * @param color RGB color struct
-     * @return ANSI escape sequence wide string for setting foreground color
+     * @return ANSI escape sequence wide string for setting foreground color in the active ColorMode
      */
     inline std::wstring wrgbToForeground(const RGB& color) {
-        return L"\x1b[38;2;" + std::to_wstring(color.r) + L";" +
-            std::to_wstring(color.g) + L";" +
-            std::to_wstring(color.b) + L"m";
+        return sgr(colorParameters(color, false));
     }
 
     /**
@@ -83,12 +278,10 @@ namespace ColorUtil {
     /**
      * @brief Converts an RGB color to an ANSI escape sequence for background color (std::wstring).
      * @param color RGB color struct
-     * @return ANSI escape sequence wide string for setting background color
+     * @return ANSI escape sequence wide string for setting background color in the active ColorMode
      */
     inline std::wstring wrgbToBackground(const RGB& color) {
-        return L"\x1b[48;2;" + std::to_wstring(color.r) + L";" +
-            std::to_wstring(color.g) + L";" +
-            std::to_wstring(color.b) + L"m";
+        return sgr(colorParameters(color, true));
     }
 
     /**
@@ -106,11 +299,11 @@ namespace ColorUtil {
      * @brief Generates an ANSI escape sequence for both foreground and background colors (std::wstring).
      * @param fg Foreground RGB color struct
      * @param bg Background RGB color struct
-     * @return ANSI escape sequence wide string setting both foreground and background colors
+     * @return ANSI escape sequence wide string setting both foreground and background colors in the active ColorMode
      */
     inline std::wstring wrgbBoth(const RGB& fg, const RGB& bg) {
-        return L"\033[38;2;" + std::to_wstring(fg.r) + L";" + std::to_wstring(fg.g) + L";" + std::to_wstring(fg.b) +
-            L";48;2;" + std::to_wstring(bg.r) + L";" + std::to_wstring(bg.g) + L";" + std::to_wstring(bg.b) + L"m";
+        if (activeColorMode == ColorMode::None) return L"";
+        return sgr(colorParameters(fg, false) + L";" + colorParameters(bg, true));
     }
 
     /**
@@ -118,12 +311,10 @@ namespace ColorUtil {
      * @param r Red component (0-255)
      * @param g Green component (0-255)
      * @param b Blue component (0-255)
-     * @return ANSI escape sequence wide string for setting foreground color
+     * @return ANSI escape sequence wide string for setting foreground color in the active ColorMode
      */
     inline std::wstring wrgbToForeground(int r, int g, int b) {
-        return L"\x1b[38;2;" + std::to_wstring(r) + L";" +
-            std::to_wstring(g) + L";" +
-            std::to_wstring(b) + L"m";
+        return wrgbToForeground(RGB{ r, g, b });
     }
 
     /**
@@ -131,12 +322,10 @@ namespace ColorUtil {
      * @param r Red component (0-255)
      * @param g Green component (0-255)
      * @param b Blue component (0-255)
-     * @return ANSI escape sequence wide string for setting background color
+     * @return ANSI escape sequence wide string for setting background color in the active ColorMode
      */
     inline std::wstring wrgbToBackground(int r, int g, int b) {
-        return L"\x1b[48;2;" + std::to_wstring(r) + L";" +
-            std::to_wstring(g) + L";" +
-            std::to_wstring(b) + L"m";
+        return wrgbToBackground(RGB{ r, g, b });
     }
 
     /**
@@ -188,11 +377,10 @@ namespace ColorUtil {
      * @param bg_r Background red component (0-255)
      * @param bg_g Background green component (0-255)
      * @param bg_b Background blue component (0-255)
-     * @return ANSI escape sequence wide string setting both foreground and background colors
+     * @return ANSI escape sequence wide string setting both foreground and background colors in the active ColorMode
      */
     inline std::wstring wrgbBoth(int fg_r, int fg_g, int fg_b, int bg_r, int bg_g, int bg_b) {
-        return L"\033[38;2;" + std::to_wstring(fg_r) + L";" + std::to_wstring(fg_g) + L";" + std::to_wstring(fg_b) +
-            L";48;2;" + std::to_wstring(bg_r) + L";" + std::to_wstring(bg_g) + L";" + std::to_wstring(bg_b) + L"m";
+        return wrgbBoth(RGB{ fg_r, fg_g, fg_b }, RGB{ bg_r, bg_g, bg_b });
     }
 
     /**
@@ -1,10 +1,13 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <string_view>
 
 /**
  * @file hash_util.hpp
  * @brief Provides constexpr and runtime FNV-1a hash functions for strings and character arrays.
+ *
+ * The 32-bit variants are used to switch over command names, the 64-bit variant keys search tables.
  */
 
  /**
@@ -70,3 +73,35 @@ static inline unsigned int hash(const std::string& s)
 {
     return hash(s.data(), static_cast<unsigned int>(s.size()));
 }
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a byte sequence.
+ * @param data Pointer to the input data.
+ * @param len Length of the input data.
+ * @return 64-bit hash value.
+ */
+static inline constexpr uint64_t hash64(const char* data, size_t len)
+{
+    constexpr uint64_t basis = 0xcbf29ce484222325ULL;
+    constexpr uint64_t prime = 0x100000001b3ULL;
+
+    uint64_t hash = basis;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= prime;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a std::string at runtime.
+ * @param s The input string.
+ * @return 64-bit hash value.
+ */
+static inline uint64_t hash64(const std::string& s)
+{
+    return hash64(s.data(), s.size());
+}
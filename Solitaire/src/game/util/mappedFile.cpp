@@ -0,0 +1,116 @@
+#include "mappedFile.hpp"
+#include <cstdint>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::OpenStatus MappedFile::open(const std::string& path, std::size_t size) {
+    close();
+    if (size == 0) return OpenStatus::Failed;
+
+#ifdef _WIN32
+    // share mode 0 keeps every other open of the file failing until this handle is closed
+    HANDLE opened = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (opened == INVALID_HANDLE_VALUE) {
+        return GetLastError() == ERROR_SHARING_VIOLATION ? OpenStatus::InUse : OpenStatus::Failed;
+    }
+    file = opened;
+
+    LARGE_INTEGER current;
+    if (!GetFileSizeEx(opened, &current)) {
+        close();
+        return OpenStatus::Failed;
+    }
+    previous = static_cast<std::size_t>(current.QuadPart);
+    if (previous != size) {
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(opened, end, nullptr, FILE_BEGIN) || !SetEndOfFile(opened)) {
+            close();
+            return OpenStatus::Failed;
+        }
+    }
+
+    uint64_t size64 = size;
+    mapping = CreateFileMappingA(opened, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFF), nullptr);
+    if (mapping == nullptr) {
+        close();
+        return OpenStatus::Failed;
+    }
+    view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (view == nullptr) {
+        close();
+        return OpenStatus::Failed;
+    }
+#else
+    descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (descriptor < 0) return OpenStatus::Failed;
+
+    // the lock is taken before the size is touched, so a file in use is never truncated
+    if (flock(descriptor, LOCK_EX | LOCK_NB) != 0) {
+        bool inUse = errno == EWOULDBLOCK;
+        close();
+        return inUse ? OpenStatus::InUse : OpenStatus::Failed;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        close();
+        return OpenStatus::Failed;
+    }
+    previous = static_cast<std::size_t>(info.st_size);
+    if (previous != size && ftruncate(descriptor, static_cast<off_t>(size)) != 0) {
+        close();
+        return OpenStatus::Failed;
+    }
+
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        return OpenStatus::Failed;
+    }
+    view = mapped;
+#endif
+    length = size;
+    return OpenStatus::Opened;
+}
+
+void MappedFile::flush(std::size_t offset, std::size_t size) {
+    if (view == nullptr || offset >= length) return;
+    if (size == 0 || offset + size > length) size = length - offset;
+
+#ifdef _WIN32
+    FlushViewOfFile(static_cast<char*>(view) + offset, size);
+    FlushFileBuffers(file);
+#else
+    // msync needs a page-aligned start
+    std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::size_t start = offset / page * page;
+    msync(static_cast<char*>(view) + start, size + (offset - start), MS_SYNC);
+#endif
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (view != nullptr) UnmapViewOfFile(view);
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (file != nullptr) CloseHandle(file);
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (view != nullptr) munmap(view, length);
+    if (descriptor >= 0) ::close(descriptor);
+    descriptor = -1;
+#endif
+    view = nullptr;
+    length = 0;
+    previous = 0;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @file mappedFile.hpp
+ * @brief Declares MappedFile, a file mapped read-write into memory.
+ */
+
+/**
+ * @class MappedFile
+ * @brief Maps a whole file into memory with CreateFileMapping on Windows and mmap elsewhere.
+ *
+ * The file is created if needed and resized to the requested size; previousSize tells whether
+ * existing contents may be reused. Writes to data() reach the file when flushed or unmapped.
+ * The file is held exclusively while it is open, with flock on POSIX systems and a share mode
+ * of 0 on Windows, so a second process, or a second MappedFile, cannot map it at the same time.
+ * System handles are kept as plain values so that including this header does not pull in the
+ * platform headers.
+ */
+class MappedFile {
+public:
+    /**
+     * @enum OpenStatus
+     * @brief Outcome of opening a file.
+     */
+    enum class OpenStatus : unsigned char {
+        Opened,  ///< The file is mapped and locked.
+        InUse,   ///< Another process or MappedFile holds the file.
+        Failed   ///< Any other system error.
+    };
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    /**
+     * @brief Opens or creates a file, locks it and maps it.
+     * @param path Path to the file.
+     * @param size Size of the mapping, the file is grown or shrunk to it once it is locked.
+     * @return Opened if the file is mapped, InUse if it is locked elsewhere, Failed otherwise.
+     */
+    OpenStatus open(const std::string& path, std::size_t size);
+
+    /**
+     * @brief Writes changed pages of a range back to the file and waits for it.
+     * @param offset Start of the range.
+     * @param size Length of the range, 0 for everything from offset.
+     */
+    void flush(std::size_t offset = 0, std::size_t size = 0);
+
+    /**
+     * @brief Unmaps and closes the file, writing pending changes.
+     */
+    void close();
+
+    /**
+     * @brief Checks if a file is mapped.
+     * @return True if data() is usable.
+     */
+    bool isOpen() const { return view != nullptr; }
+
+    /**
+     * @brief Gets the mapped memory.
+     * @return Pointer to the first byte, nullptr if nothing is mapped.
+     */
+    void* data() const { return view; }
+
+    /**
+     * @brief Gets the size of the mapping.
+     * @return Size in bytes.
+     */
+    std::size_t size() const { return length; }
+
+    /**
+     * @brief Gets the size the file had before it was opened.
+     * @return Size in bytes, 0 for a new file.
+     */
+    std::size_t previousSize() const { return previous; }
+
+private:
+#ifdef _WIN32
+    void* file = nullptr;                ///< Open file handle, nullptr when closed.
+    void* mapping = nullptr;             ///< File mapping object handle.
+#else
+    int descriptor = -1;                 ///< Open file descriptor.
+#endif
+    void* view = nullptr;                ///< Mapped memory.
+    std::size_t length = 0;              ///< Size of the mapping.
+    std::size_t previous = 0;            ///< File size before opening.
+};
@@ -0,0 +1,189 @@
+#pragma once
+#include <cstdint>
+#include <sstream>
+#include <string>
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file perfCounters.hpp
+ * @brief Provides PerfCounters, hardware event counters of the calling thread read around a piece of code.
+ */
+
+/**
+ * @class PerfCounters
+ * @brief Counts cycles, instructions, cache misses and branch misses with perf_event_open on Linux.
+ *
+ * All counters are opened as one group, so they run over the same instructions, and only user
+ * space is counted, which unprivileged processes may do with the default perf_event_paranoid
+ * setting; time spent in system calls such as terminal writes is therefore not included. A
+ * counter the processor or a virtual machine does not offer is left out and reads as
+ * unavailable. On other systems, or when perf_event_open is refused, open fails and every
+ * sample is unavailable, so callers measure the same way everywhere.
+ */
+class PerfCounters {
+public:
+    /**
+     * @enum Counter
+     * @brief Hardware events read by PerfCounters.
+     */
+    enum Counter {
+        Cycles,        ///< CPU cycles.
+        Instructions,  ///< Retired instructions.
+        CacheMisses,   ///< Last level cache misses.
+        BranchMisses,  ///< Mispredicted branches.
+        counterCount
+    };
+
+    /**
+     * @struct Sample
+     * @brief Counts of one measured interval.
+     */
+    struct Sample {
+        int64_t values[counterCount] = { -1, -1, -1, -1 }; ///< Count of every counter, -1 if unavailable.
+
+        /**
+         * @brief Checks if any counter was read.
+         * @return True if at least one value is known.
+         */
+        bool available() const {
+            for (int64_t value : values) {
+                if (value >= 0) return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Formats the counts as one JSON object, unavailable counters as null.
+         * @return JSON text, null when no counter was read.
+         */
+        std::string toJson() const {
+            if (!available()) return "null";
+            static const char* const names[counterCount] = { "cycles", "instructions", "cache_misses", "branch_misses" };
+            std::ostringstream out;
+            out << "{";
+            for (int i = 0; i < counterCount; i++) {
+                out << (i > 0 ? "," : "") << "\"" << names[i] << "\":";
+                if (values[i] >= 0) out << values[i];
+                else out << "null";
+            }
+            out << ",\"instructions_per_cycle\":";
+            if (values[Cycles] > 0 && values[Instructions] >= 0) {
+                out << static_cast<double>(values[Instructions]) / static_cast<double>(values[Cycles]);
+            }
+            else {
+                out << "null";
+            }
+            out << "}";
+            return out.str();
+        }
+    };
+
+    PerfCounters() = default;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        close();
+    }
+
+    /**
+     * @brief Opens the counters for the calling thread, stopped.
+     * @return True if at least one counter is open, false if none is offered or allowed.
+     */
+    bool open() {
+        close();
+#ifdef __linux__
+        static const uint64_t events[counterCount] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (int i = 0; i < counterCount; i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = events[i];
+            // the first open counter leads the group and starts and stops the others with it
+            attr.disabled = leader < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            long descriptor = syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+            if (descriptor < 0) continue;
+            descriptors[i] = static_cast<int>(descriptor);
+            if (leader < 0) leader = descriptors[i];
+        }
+#endif
+        return isOpen();
+    }
+
+    /**
+     * @brief Zeroes and starts the counters.
+     */
+    void start() {
+#ifdef __linux__
+        if (leader < 0) return;
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /**
+     * @brief Stops the counters and reads them.
+     * @return Counts since start, scaled up if the kernel shared the counters with other groups.
+     */
+    Sample stop() {
+        Sample sample;
+#ifdef __linux__
+        if (leader < 0) return sample;
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // number of counters, time enabled, time running, then the values in the order they were opened
+        uint64_t buffer[3 + counterCount];
+        if (read(leader, buffer, sizeof(buffer)) < static_cast<ssize_t>(3 * sizeof(uint64_t))) return sample;
+        uint64_t enabled = buffer[1];
+        uint64_t running = buffer[2];
+        if (running == 0) return sample;
+
+        double scale = static_cast<double>(enabled) / static_cast<double>(running);
+        uint64_t next = 0;
+        for (int i = 0; i < counterCount && next < buffer[0]; i++) {
+            if (descriptors[i] < 0) continue;
+            sample.values[i] = static_cast<int64_t>(static_cast<double>(buffer[3 + next]) * scale);
+            next++;
+        }
+#endif
+        return sample;
+    }
+
+    /**
+     * @brief Closes the counters.
+     */
+    void close() {
+#ifdef __linux__
+        // members first, the group goes away with its leader
+        for (int i = counterCount - 1; i >= 0; i--) {
+            if (descriptors[i] >= 0) ::close(descriptors[i]);
+            descriptors[i] = -1;
+        }
+#endif
+        leader = -1;
+    }
+
+    /**
+     * @brief Checks if any counter is open.
+     * @return True if stop can return counts.
+     */
+    bool isOpen() const { return leader >= 0; }
+
+private:
+    int descriptors[counterCount] = { -1, -1, -1, -1 }; ///< Descriptor of every counter, -1 if not open.
+    int leader = -1;                                   ///< Descriptor of the group leader, -1 if nothing is open.
+};
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef _WIN32
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file rawInput.hpp
+ * @brief Switches standard input between line input and single keystrokes.
+ */
+
+namespace RawInput {
+
+#ifndef _WIN32
+    /// Terminal settings before enable(), restored by disable().
+    inline termios savedSettings{};
+    /// True while the terminal is in key mode.
+    inline bool keysEnabled = false;
+#endif
+
+    /**
+     * @brief Delivers every key as soon as it is pressed, without echo or line editing.
+     *
+     * On Linux turns off canonical mode and echo, keeping Ctrl+C. The Windows console is read
+     * through input events already, so there is nothing to change. Input that is not a terminal
+     * is left as it is and read byte by byte anyway.
+     *
+     * @return true if keys arrive one by one, false if standard input could not be switched.
+     */
+    inline bool enable() {
+#ifdef _WIN32
+        return true;
+#else
+        if (keysEnabled) return true;
+        if (!isatty(STDIN_FILENO)) return true;
+        if (tcgetattr(STDIN_FILENO, &savedSettings) != 0) return false;
+
+        termios settings = savedSettings;
+        settings.c_lflag &= ~(ICANON | ECHO);
+        settings.c_cc[VMIN] = 1;
+        settings.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSANOW, &settings) != 0) return false;
+        keysEnabled = true;
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Restores line input as it was before enable(), does nothing if it was not called.
+     */
+    inline void disable() {
+#ifndef _WIN32
+        if (!keysEnabled) return;
+        tcsetattr(STDIN_FILENO, TCSANOW, &savedSettings);
+        keysEnabled = false;
+#endif
+    }
+
+} // namespace RawInput
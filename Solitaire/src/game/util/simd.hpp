@@ -0,0 +1,129 @@
+#pragma once
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOLITAIRE_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @file simd.hpp
+ * @brief Provides operations on rows of 16 bytes, with SSE2 where the target has it and plain loops elsewhere.
+ */
+
+/**
+ * @namespace Simd
+ * @brief Byte-row operations shared by the structure-of-arrays game layouts.
+ *
+ * A row holds 16 unsigned bytes, one per lane. Comparisons return rows of 0xFF for true and 0
+ * for false, so they combine with both, either and butNot, and laneMask turns them into bits.
+ * SSE2 is part of every x64 target and of 32-bit MSVC builds by default; the loop versions keep
+ * other targets building with the same results.
+ */
+namespace Simd {
+
+    static const int lanes = 16; ///< Bytes in a row.
+
+#ifdef SOLITAIRE_SSE2
+    /// Row of 16 bytes in a register.
+    using Bytes = __m128i;
+
+    /**
+     * @brief Loads a row.
+     * @param data 16 bytes aligned to 16.
+     * @return Loaded row.
+     */
+    inline Bytes load(const uint8_t* data) { return _mm_load_si128(reinterpret_cast<const __m128i*>(data)); }
+
+    /**
+     * @brief Stores a row.
+     * @param data 16 bytes aligned to 16.
+     * @param row Row to store.
+     */
+    inline void store(uint8_t* data, Bytes row) { _mm_store_si128(reinterpret_cast<__m128i*>(data), row); }
+
+    /**
+     * @brief Repeats a value in every lane.
+     * @param value Byte to repeat.
+     * @return Row of value.
+     */
+    inline Bytes splat(uint8_t value) { return _mm_set1_epi8(static_cast<char>(value)); }
+
+    inline Bytes equal(Bytes a, Bytes b) { return _mm_cmpeq_epi8(a, b); }          ///< 0xFF where a == b.
+    inline Bytes both(Bytes a, Bytes b) { return _mm_and_si128(a, b); }            ///< Bitwise a & b.
+    inline Bytes either(Bytes a, Bytes b) { return _mm_or_si128(a, b); }           ///< Bitwise a | b.
+    inline Bytes butNot(Bytes a, Bytes b) { return _mm_andnot_si128(b, a); }       ///< Bitwise a & ~b.
+    inline Bytes differ(Bytes a, Bytes b) { return _mm_xor_si128(a, b); }          ///< Bitwise a ^ b.
+    inline Bytes plus(Bytes a, Bytes b) { return _mm_add_epi8(a, b); }             ///< a + b, wrapping.
+    inline Bytes minus(Bytes a, Bytes b) { return _mm_sub_epi8(a, b); }            ///< a - b, wrapping.
+    inline Bytes lower(Bytes a, Bytes b) { return _mm_min_epu8(a, b); }            ///< Unsigned minimum.
+    inline Bytes higher(Bytes a, Bytes b) { return _mm_max_epu8(a, b); }           ///< Unsigned maximum.
+
+    /**
+     * @brief Collects the top bit of every lane.
+     * @param row Row of comparison results.
+     * @return Bit i set where lane i is 0xFF.
+     */
+    inline unsigned laneMask(Bytes row) { return static_cast<unsigned>(_mm_movemask_epi8(row)); }
+#else
+    /**
+     * @brief Row of 16 bytes in memory, for targets without SSE2.
+     */
+    struct Bytes {
+        uint8_t lane[lanes]; ///< Byte of every lane.
+    };
+
+    /// @brief Applies a byte operation lane by lane.
+    template <typename Operation>
+    inline Bytes eachLane(Bytes a, Bytes b, Operation operation) {
+        Bytes result;
+        for (int i = 0; i < lanes; i++) result.lane[i] = static_cast<uint8_t>(operation(a.lane[i], b.lane[i]));
+        return result;
+    }
+
+    inline Bytes load(const uint8_t* data) {
+        Bytes row;
+        for (int i = 0; i < lanes; i++) row.lane[i] = data[i];
+        return row;
+    }
+
+    inline void store(uint8_t* data, Bytes row) {
+        for (int i = 0; i < lanes; i++) data[i] = row.lane[i];
+    }
+
+    inline Bytes splat(uint8_t value) {
+        Bytes row;
+        for (int i = 0; i < lanes; i++) row.lane[i] = value;
+        return row;
+    }
+
+    inline Bytes equal(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x == y ? 0xFF : 0; }); }
+    inline Bytes both(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x & y; }); }
+    inline Bytes either(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x | y; }); }
+    inline Bytes butNot(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x & ~y; }); }
+    inline Bytes differ(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x ^ y; }); }
+    inline Bytes plus(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x + y; }); }
+    inline Bytes minus(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x - y; }); }
+    inline Bytes lower(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x < y ? x : y; }); }
+    inline Bytes higher(Bytes a, Bytes b) { return eachLane(a, b, [](uint8_t x, uint8_t y) { return x > y ? x : y; }); }
+
+    inline unsigned laneMask(Bytes row) {
+        unsigned mask = 0;
+        for (int i = 0; i < lanes; i++) mask |= static_cast<unsigned>(row.lane[i] >> 7) << i;
+        return mask;
+    }
+#endif
+
+    /**
+     * @brief Tests an unsigned range in every lane.
+     * @param value Row to test.
+     * @param low Smallest accepted value.
+     * @param high Largest accepted value.
+     * @return 0xFF where low <= value <= high.
+     */
+    inline Bytes within(Bytes value, Bytes low, Bytes high) {
+        // SSE2 has no unsigned byte compare, a value is in range when clamping leaves it unchanged
+        return both(equal(higher(value, low), value), equal(lower(value, high), value));
+    }
+
+} // namespace Simd
@@ -0,0 +1,79 @@
+#pragma once
+#include "colorUtil.hpp"
+#include <string>
+
+/**
+ * @file terminalScreen.hpp
+ * @brief Escape sequences for the alternate screen, clearing and synchronized frame updates.
+ */
+
+namespace TerminalScreen {
+
+    /// Switches to the alternate screen buffer, which has no scrollback.
+    const std::wstring enterAlternateScreen = L"\x1b[?1049h";
+
+    /// Returns to the normal screen buffer with the content it had before enterAlternateScreen.
+    const std::wstring leaveAlternateScreen = L"\x1b[?1049l";
+
+    /// Moves the cursor to the top left corner and erases the screen.
+    const std::wstring clearScreen = L"\x1b[H\x1b[2J";
+
+    /// Starts a synchronized update (DEC private mode 2026), the terminal holds output until it ends.
+    const std::wstring beginSynchronizedUpdate = L"\x1b[?2026h";
+
+    /// Ends a synchronized update and lets the terminal present everything written since it began.
+    const std::wstring endSynchronizedUpdate = L"\x1b[?2026l";
+
+    /// True if frames are wrapped in synchronized updates.
+    inline bool activeSynchronizedOutput = true;
+
+    /**
+     * @brief Turns synchronized updates on or off.
+     * @param enabled True to wrap frames in synchronized updates.
+     */
+    inline void setSynchronizedOutput(bool enabled) {
+        activeSynchronizedOutput = enabled;
+    }
+
+    /**
+     * @brief Decides from the environment if frames should be wrapped in synchronized updates.
+     *
+     * SOLITAIRE_SYNC ("1" or "0") overrides detection. Terminals without mode 2026 ignore the
+     * sequences, as they do any unknown private mode, so only terminals without escape sequences
+     * (TERM=dumb) leave them out; other terminals simply show frames as they arrive.
+     *
+     * @return True if synchronized updates should be used.
+     */
+    inline bool detectSynchronizedOutput() {
+        std::string forced = ColorUtil::environmentValue("SOLITAIRE_SYNC");
+        if (forced == "1") return true;
+        if (forced == "0") return false;
+        return ColorUtil::environmentValue("TERM") != "dumb";
+    }
+
+    /**
+     * @brief Gets the sequence starting a frame.
+     * @return beginSynchronizedUpdate, or an empty string when synchronized updates are off.
+     */
+    inline std::wstring beginFrame() {
+        return activeSynchronizedOutput ? beginSynchronizedUpdate : std::wstring();
+    }
+
+    /**
+     * @brief Gets the sequence ending a frame.
+     * @return endSynchronizedUpdate, or an empty string when synchronized updates are off.
+     */
+    inline std::wstring endFrame() {
+        return activeSynchronizedOutput ? endSynchronizedUpdate : std::wstring();
+    }
+
+    /**
+     * @brief Wraps a frame written in one call in a synchronized update.
+     * @param frame Text of the frame.
+     * @return Frame between beginFrame and endFrame.
+     */
+    inline std::wstring synchronized(const std::wstring& frame) {
+        return beginFrame() + frame + endFrame();
+    }
+
+} // namespace TerminalScreen
@@ -0,0 +1,62 @@
+#pragma once
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cstdlib>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file terminalSize.hpp
+ * @brief Provides a portable query of the visible terminal size.
+ */
+
+namespace TerminalSize {
+
+    /**
+     * @brief Visible size of the terminal in character cells.
+     */
+    struct Size {
+        int columns; ///< Cells in a line.
+        int rows;    ///< Visible lines.
+    };
+
+    /**
+     * @brief Gets the size of the terminal window the program writes to.
+     *
+     * Uses the console screen buffer window on Windows and TIOCGWINSZ elsewhere, falling back to
+     * the COLUMNS and LINES variables when output is not a terminal.
+     *
+     * @param size Receives the size.
+     * @return true if the size is known, false otherwise.
+     */
+    inline bool query(Size& size) {
+#ifdef _WIN32
+        CONSOLE_SCREEN_BUFFER_INFO info;
+        if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+            return false;
+        }
+        size.columns = info.srWindow.Right - info.srWindow.Left + 1;
+        size.rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+        return true;
+#else
+        winsize window{};
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window) == 0 && window.ws_col > 0 && window.ws_row > 0) {
+            size.columns = window.ws_col;
+            size.rows = window.ws_row;
+            return true;
+        }
+
+        const char* columns = std::getenv("COLUMNS");
+        const char* rows = std::getenv("LINES");
+        if (columns == nullptr || rows == nullptr) {
+            return false;
+        }
+        size.columns = std::atoi(columns);
+        size.rows = std::atoi(rows);
+        return size.columns > 0 && size.rows > 0;
+#endif
+    }
+
+} // namespace TerminalSize
@@ -277,6 +277,38 @@ namespace WindowsConsole {
         return false;
     }
 
+    /**
+    * @brief Reads all pending console key presses as characters, without waiting and without echo.
+    *
+    * Unlike processConsoleInput it does not edit a line: Esc, Backspace and Enter are returned
+    * as the characters 0x1B, 0x08 and '\r', keys without a character (arrows, Shift) are skipped.
+    *
+    * @param keys Receives the UTF-8 text of the keys appended.
+    * @return true if any key was read, false otherwise.
+    */
+    inline bool readKeys(std::string& keys) {
+        DWORD eventsRead = 0;
+        INPUT_RECORD record;
+        bool keyRead = false;
+
+        SetConsoleMode(stdIn, ENABLE_WINDOW_INPUT | ENABLE_PROCESSED_INPUT);
+
+        while (PeekConsoleInputW(stdIn, &record, 1, &eventsRead) && eventsRead > 0) {
+            ReadConsoleInputW(stdIn, &record, 1, &eventsRead);
+
+            if (record.EventType == KEY_EVENT && record.Event.KeyEvent.bKeyDown) {
+                wchar_t wch = record.Event.KeyEvent.uChar.UnicodeChar;
+                if (wch == 0) continue;
+                for (WORD repeat = 0; repeat < record.Event.KeyEvent.wRepeatCount; ++repeat) {
+                    keys += wideCharToUtf8(wch);
+                }
+                keyRead = true;
+            }
+        }
+
+        return keyRead;
+    }
+
     /**
     * @brief Sets the console cursor position to the specified coordinates.
     *
@@ -2,14 +2,19 @@
 #include "game/util/assert.hpp"
 #include "game/util/allocator.hpp"
 #include "game/ui/ConsoleUi.hpp"
+#include "game/cli/AnalysisCli.hpp"
 #include <stdio.h>
 #include <windows.h>
 
-int main() {
+int main(int argc, char* argv[]) {
 #if defined(_DEBUG) && defined(_WIN32)
 	Allocator::initialize();
 #endif
 
+	if (argc > 1) {
+		return AnalysisCli::run(argc, argv);
+	}
+
 	Game game;
 	game.start();
 